@@ -0,0 +1,99 @@
+/*
+	Counts the heap allocations of a game step of the collision map.
+	Runs headless (no window or GL context), the entities have no mesh or gpu program.
+	usage: bin/bench_alloc [frames]
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <vector>
+
+#include "../controlers/collision.hpp"
+#include "../entities/entity.hpp"
+#include "../entities/registry.hpp"
+#include "../utils/random.hpp"
+
+//every operator new goes through here, so the counter sees everything the collision map does
+static long g_allocations = 0;
+
+void* operator new(std::size_t size){
+	g_allocations++;
+	void *ptr = std::malloc(size == 0 ? 1 : size);
+	if(ptr == nullptr){
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+void operator delete(void *ptr) noexcept {
+	std::free(ptr);
+}
+void operator delete(void *ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+#define WORLD_SIZE 300.0f
+#define GRAIN 20.0f
+
+//the same positions on every run
+static utils::Random pos_random;
+
+auto random_pos() -> glm::vec4 {
+	const float x = WORLD_SIZE * pos_random.unit();
+	const float z = WORLD_SIZE * pos_random.unit();
+	return glm::vec4(x, 0.0f, z, 1.0f);
+}
+
+//the collision work Simulation::update_enemies does for each enemy: one sweep, the slide and the relocate
+auto step(controler::CollisionMap &map, const entity::Registry &registry, const std::vector<entity::Handle> &movers) -> void {
+	for(const auto handle : movers){
+		const auto mover = registry.get(handle);
+		const auto old_cords = mover->get_cords();
+		mover->rotate_increment(0.0f, 0.01f, 0.0f);
+
+		const auto dir = mover->get_direction();
+		const auto displacement = glm::vec4(dir.x, 0.0f, dir.z, 0.0f) * mover->get_speed();
+		const auto sweep = map.sweep(handle, displacement);
+		mover->translate(displacement * sweep.time + sweep.remainder);
+		map.relocate(handle, old_cords, mover->get_cords());
+	}
+}
+
+auto run(controler::BroadPhaseType type, const char *name, int n_movers, int frames) -> void {
+	entity::Registry registry;
+	controler::CollisionMap map(registry, WORLD_SIZE, WORLD_SIZE, GRAIN, GRAIN, type);
+	std::vector<entity::Handle> movers;
+	movers.reserve(n_movers);
+	for(int i = 0; i < n_movers; i++){
+		std::shared_ptr<entity::Enemy> enemy(new entity::Enemy(random_pos(), nullptr, nullptr));
+		enemy->set_bbox_type(entity::BBoxType::Cylinder);
+		enemy->set_bbox_size(1.0f, 2.0f, 1.0f);
+		enemy->set_speed(0.05f);
+		const auto handle = registry.create(enemy);
+		movers.push_back(handle);
+		map.insert_mover(handle);
+	}
+	//warm up, lets the cells grow to their working size
+	step(map, registry, movers);
+
+	const long before = g_allocations;
+	for(int i = 0; i < frames; i++){
+		step(map, registry, movers);
+	}
+	const long allocations = g_allocations - before;
+	std::printf("%s,%d,%.2f,%.4f\n", name, n_movers,
+		allocations / static_cast<double>(frames),
+		allocations / static_cast<double>(frames) / n_movers);
+}
+
+int main(int argc, char** argv){
+	const int frames = argc > 1 ? std::atoi(argv[1]) : 10;
+	pos_random.seed(0);
+	std::printf("broadphase,movers,allocations_per_frame,allocations_per_mover\n");
+	const int counts[] = {1000, 10000};
+	for(int n : counts){
+		run(controler::BroadPhaseType::Hash, "hash", n, frames);
+		run(controler::BroadPhaseType::Grid, "grid", n, frames);
+	}
+	return 0;
+}
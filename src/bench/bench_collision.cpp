@@ -0,0 +1,136 @@
+/*
+	Times the collision map: inserts, removes, colide_direction queries and full enemy ticks.
+	Runs headless (no window or GL context), the entities have no mesh or gpu program.
+	The world grows with N so the density stays the same between the runs.
+	usage: bin/bench_collision [movers per 100 square units] [walls per mover] [ticks]
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "../controlers/collision.hpp"
+#include "../entities/entity.hpp"
+#include "../entities/registry.hpp"
+#include "../utils/random.hpp"
+
+//side of a broadphase cell, the map takes how many cells fit on each side
+#define CELL_SIZE 10.0f
+
+using Clock = std::chrono::steady_clock;
+
+auto elapsed_ns(Clock::time_point start) -> double {
+	return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+//the same positions on every run
+static utils::Random pos_random;
+
+auto random_pos(float world_size) -> glm::vec4 {
+	const float x = world_size * pos_random.unit();
+	const float z = world_size * pos_random.unit();
+	return glm::vec4(x, 0.0f, z, 1.0f);
+}
+
+auto make_mover(float world_size) -> std::shared_ptr<entity::Enemy> {
+	std::shared_ptr<entity::Enemy> enemy(new entity::Enemy(random_pos(world_size), nullptr, nullptr));
+	enemy->set_bbox_type(entity::BBoxType::Cylinder);
+	enemy->set_bbox_size(1.0f, 2.0f, 1.0f);
+	enemy->set_speed(1.0f);
+	return enemy;
+}
+
+auto make_wall(float world_size) -> std::shared_ptr<entity::Wall> {
+	std::shared_ptr<entity::Wall> wall(new entity::Wall(random_pos(world_size), nullptr, nullptr));
+	wall->set_bbox_type(entity::BBoxType::Rectangle);
+	wall->set_bbox_size(2.0f, 2.0f, 2.0f);
+	return wall;
+}
+
+//the collision work Simulation::update_enemies does for each enemy, with a fixed frame time
+auto tick(controler::CollisionMap &map, const entity::Registry &registry, const std::vector<entity::Handle> &movers) -> void {
+	const float delta_time = 1.0f / 60.0f;
+	for(const auto handle : movers){
+		const auto mover = registry.get(handle);
+		const auto old_cords = mover->get_cords();
+		mover->rotate_increment(0.0f, 0.05f, 0.0f);
+		const auto dir = mover->get_direction();
+		const auto displacement = glm::vec4(dir.x, 0.0f, dir.z, 0.0f) * (mover->get_speed() * delta_time);
+		const auto sweep = map.sweep(handle, displacement);
+		mover->translate(displacement * sweep.time + sweep.remainder);
+		map.relocate(handle, old_cords, mover->get_cords());
+	}
+}
+
+auto run(controler::BroadPhaseType type, const char *name, int n, float density, float walls_per_mover, int ticks) -> void {
+	const float world_size = sqrtf(n * 100.0f / density);
+	const float grain = ceilf(world_size / CELL_SIZE);
+	entity::Registry registry;
+	controler::CollisionMap map(registry, world_size, world_size, grain, grain, type);
+
+	std::vector<entity::Handle> movers;
+	std::vector<entity::Handle> walls;
+	const int n_walls = static_cast<int>(n * walls_per_mover);
+	movers.reserve(n);
+	walls.reserve(n_walls);
+	for(int i = 0; i < n; i++){
+		movers.push_back(registry.create(make_mover(world_size)));
+	}
+	for(int i = 0; i < n_walls; i++){
+		walls.push_back(registry.create(make_wall(world_size)));
+	}
+
+	auto start = Clock::now();
+	for(const auto wall : walls){
+		map.insert_obj(wall);
+	}
+	for(const auto mover : movers){
+		map.insert_mover(mover);
+	}
+	const double insert_ns = elapsed_ns(start) / (n + n_walls);
+
+	long hits = 0;
+	start = Clock::now();
+	for(const auto mover : movers){
+		if(!map.colide_direction(mover, registry.get(mover)->get_parcial_direction_x()).is_null()){
+			hits++;
+		}
+	}
+	const double colide_ns = elapsed_ns(start) / n;
+
+	//warm up, lets the cells grow to their working size
+	tick(map, registry, movers);
+	start = Clock::now();
+	for(int i = 0; i < ticks; i++){
+		tick(map, registry, movers);
+	}
+	const double tick_ns = elapsed_ns(start) / ticks;
+
+	start = Clock::now();
+	for(const auto mover : movers){
+		map.remove_mover(mover);
+	}
+	for(const auto wall : walls){
+		map.remove_obj(wall);
+	}
+	const double remove_ns = elapsed_ns(start) / (n + n_walls);
+
+	std::printf("%s,%d,%d,%.3f,%.1f,%.1f,%.1f,%.0f,%.1f,%ld\n", name, n, n_walls, density,
+		insert_ns, remove_ns, colide_ns, tick_ns, tick_ns / n, hits);
+}
+
+int main(int argc, char** argv){
+	const float density = argc > 1 ? std::atof(argv[1]) : 1.0f;
+	const float walls_per_mover = argc > 2 ? std::atof(argv[2]) : 0.5f;
+	const int ticks = argc > 3 ? std::atoi(argv[3]) : 5;
+	pos_random.seed(0);
+	std::printf("broadphase,movers,walls,density,insert_ns,remove_ns,colide_direction_ns,tick_ns,tick_ns_per_mover,hits\n");
+	const int counts[] = {100, 1000, 10000, 100000};
+	for(int n : counts){
+		run(controler::BroadPhaseType::Hash, "hash", n, density, walls_per_mover, ticks);
+		run(controler::BroadPhaseType::Grid, "grid", n, density, walls_per_mover, ticks);
+	}
+	return 0;
+}
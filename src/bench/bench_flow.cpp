@@ -0,0 +1,104 @@
+/*
+	Time to update the flow field when the player walks to the next tile, rebuilding it whole against repairing it.
+	The maps are a wave function collapse map of the game size repeated to fill the bigger sizes,
+	the collapse itself is too slow to make a 1000 x 1000 map.
+	usage: bin/bench_flow [steps]
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+#include "../controlers/flow_field.hpp"
+#include "../controlers/gamemap.hpp"
+#include "../utils/random.hpp"
+
+#define TILE_SIZE 15.0f
+#define PATTERN_SIZE 10
+
+using Clock = std::chrono::steady_clock;
+
+auto make_map(int size) -> std::vector<char> {
+	controler::WaveFuncMap wave_map(PATTERN_SIZE, 2);
+	wave_map.set_seed(1);
+	const auto pattern = wave_map.generate();
+	std::vector<char> char_map(size * size);
+	for(int z = 0; z < size; z++){
+		for(int x = 0; x < size; x++){
+			char_map[x + z * size] = pattern[(x % PATTERN_SIZE) + (z % PATTERN_SIZE) * PATTERN_SIZE];
+		}
+	}
+	return char_map;
+}
+
+inline auto tile_center(int tile, int size) -> glm::vec4 {
+	return glm::vec4((tile % size) * 2 * TILE_SIZE + TILE_SIZE / 2, 0.0f, (tile / size) * 2 * TILE_SIZE + TILE_SIZE / 2, 1.0f);
+}
+
+//the tiles the player walks through, one step to a side each time, never into a house
+auto make_walk(const std::vector<char> &char_map, int size, int steps) -> std::vector<int> {
+	utils::Random random(7);
+	int tile = 0;
+	while(char_map[tile] == '#'){
+		tile++;
+	}
+	std::vector<int> walk{tile};
+	const int dx[4] = {1, -1, 0, 0};
+	const int dz[4] = {0, 0, 1, -1};
+	while(static_cast<int>(walk.size()) <= steps){
+		const int d = static_cast<int>(random.below(4));
+		const int x = tile % size + dx[d];
+		const int z = tile / size + dz[d];
+		if(x < 0 || x >= size || z < 0 || z >= size || char_map[x + z * size] == '#'){
+			continue;
+		}
+		tile = x + z * size;
+		walk.push_back(tile);
+	}
+	return walk;
+}
+
+struct Run{
+	double us_per_update;
+	double touched_per_update;
+};
+
+auto run(controler::FlowField &field, const std::vector<int> &walk, int size) -> Run {
+	field.update(tile_center(walk[0], size));
+	long touched = 0;
+	const auto start = Clock::now();
+	for(size_t i = 1; i < walk.size(); i++){
+		field.update(tile_center(walk[i], size));
+		touched += field.get_last_touched();
+	}
+	const double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+	const double updates = static_cast<double>(walk.size() - 1);
+	return Run{us / updates, touched / updates};
+}
+
+int main(int argc, char** argv){
+	const int steps = argc > 1 ? std::atoi(argv[1]) : 50;
+	std::printf("size,tiles,steps,full_us,incremental_us,full_touched,incremental_touched,same_costs\n");
+	const int sizes[] = {10, 100, 1000};
+	for(int size : sizes){
+		const auto char_map = make_map(size);
+		const auto walk = make_walk(char_map, size, steps);
+
+		controler::FlowField full, incremental;
+		full.build(char_map, size, TILE_SIZE);
+		full.set_incremental(false);
+		incremental.build(char_map, size, TILE_SIZE);
+
+		const auto full_run = run(full, walk, size);
+		const auto incremental_run = run(incremental, walk, size);
+		//both end at the same target, the repair has to give the costs of the dijkstra
+		bool same = true;
+		for(int tile = 0; tile < size * size && same; tile++){
+			same = full.get_cost(tile) == incremental.get_cost(tile);
+		}
+		std::printf("%d,%d,%d,%.1f,%.1f,%.0f,%.0f,%s\n", size, size * size, steps,
+			full_run.us_per_update, incremental_run.us_per_update,
+			full_run.touched_per_update, incremental_run.touched_per_update, same ? "yes" : "no");
+	}
+	return 0;
+}
@@ -0,0 +1,115 @@
+/*
+	Throughput of the job system: empty jobs, parallel_for against a plain loop and a task graph.
+	usage: bin/bench_jobs [threads] [repeats]
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+#include "../utils/job_system.hpp"
+
+#define ELEMENTS (1 << 20)
+#define EMPTY_JOBS 100000
+#define GRAPH_WIDTH 64
+#define GRAPH_DEPTH 16
+
+using Clock = std::chrono::steady_clock;
+
+auto seconds_since(Clock::time_point start) -> double {
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+//a bit of float math per element, about what a steering or sweep step costs
+inline auto work(float v) -> float {
+	return sqrtf(v * v + 1.0f) * 0.5f + sinf(v);
+}
+
+auto bench_empty(utils::JobSystem &jobs, int repeats) -> void {
+	std::atomic<int> ran(0);
+	const auto start = Clock::now();
+	for(int r = 0; r < repeats; r++){
+		utils::TaskGroup group;
+		for(int i = 0; i < EMPTY_JOBS; i++){
+			jobs.run(group, [&](int){ ran.fetch_add(1, std::memory_order_relaxed); });
+		}
+		jobs.wait(group);
+	}
+	const double elapsed = seconds_since(start);
+	std::printf("empty,%d,0,%.0f,%.1f\n", jobs.get_worker_count(), ran.load() / elapsed, elapsed * 1e9 / ran.load());
+}
+
+auto bench_parallel_for(utils::JobSystem &jobs, int repeats) -> void {
+	std::vector<float> in(ELEMENTS), out(ELEMENTS);
+	for(int i = 0; i < ELEMENTS; i++){
+		in[i] = i * 0.001f;
+	}
+	auto start = Clock::now();
+	for(int r = 0; r < repeats; r++){
+		for(int i = 0; i < ELEMENTS; i++){
+			out[i] = work(in[i]);
+		}
+	}
+	const double serial = seconds_since(start) / repeats;
+	std::printf("serial_for,1,%d,%.0f,%.1f\n", ELEMENTS, ELEMENTS / serial, serial * 1e9 / ELEMENTS);
+
+	const int chunks[] = {64, 1024, 16384};
+	for(int chunk : chunks){
+		start = Clock::now();
+		for(int r = 0; r < repeats; r++){
+			jobs.parallel_for(ELEMENTS, chunk, [&](int begin, int end, int){
+				for(int i = begin; i < end; i++){
+					out[i] = work(in[i]);
+				}
+			});
+		}
+		const double elapsed = seconds_since(start) / repeats;
+		std::printf("parallel_for,%d,%d,%.0f,%.1f\n", jobs.get_worker_count(), chunk, ELEMENTS / elapsed, elapsed * 1e9 / ELEMENTS);
+	}
+}
+
+//layers of nodes, each one depends on two of the layer before
+auto bench_graph(utils::JobSystem &jobs, int repeats) -> void {
+	utils::TaskGraph graph;
+	std::vector<float> values(GRAPH_WIDTH * GRAPH_DEPTH, 1.0f);
+	for(int d = 0; d < GRAPH_DEPTH; d++){
+		for(int w = 0; w < GRAPH_WIDTH; w++){
+			const int id = d * GRAPH_WIDTH + w;
+			graph.add([&values, id](int){
+				float v = values[id];
+				for(int i = 0; i < 256; i++){
+					v = work(v);
+				}
+				values[id] = v;
+			});
+			if(d > 0){
+				graph.precede(id - GRAPH_WIDTH, id);
+				graph.precede((d - 1) * GRAPH_WIDTH + (w + 1) % GRAPH_WIDTH, id);
+			}
+		}
+	}
+	const auto start = Clock::now();
+	for(int r = 0; r < repeats; r++){
+		graph.run(jobs);
+	}
+	const double elapsed = seconds_since(start);
+	const int nodes = graph.size() * repeats;
+	std::printf("graph,%d,%d,%.0f,%.1f\n", jobs.get_worker_count(), graph.size(), nodes / elapsed, elapsed * 1e9 / nodes);
+}
+
+int main(int argc, char** argv){
+	const int hardware = static_cast<int>(std::thread::hardware_concurrency());
+	const int threads = argc > 1 ? std::atoi(argv[1]) : std::max(hardware - 1, 0);
+	const int repeats = argc > 2 ? std::atoi(argv[2]) : 10;
+
+	utils::JobSystem jobs(threads);
+	std::printf("test,workers,size,items_per_second,ns_per_item\n");
+	bench_empty(jobs, repeats);
+	bench_parallel_for(jobs, repeats);
+	bench_graph(jobs, repeats);
+	std::printf("steals,%ld\n", jobs.get_steals());
+	return 0;
+}
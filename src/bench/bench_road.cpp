@@ -0,0 +1,135 @@
+/*
+	Time to build the road graph of a map and to find paths on it, the first time a pair of regions is asked
+	for (A* over the road nodes) and again (from the route cache).
+	Also checks the paths: no stretch between two waypoints goes over a house, and a pair without a path
+	is one the flow field can't reach either.
+	The maps are a wave function collapse map of the game size repeated to fill the bigger sizes, like in bench_flow.
+	usage: bin/bench_road [queries]
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <vector>
+
+#include "../controlers/road_planner.hpp"
+#include "../controlers/flow_field.hpp"
+#include "../controlers/gamemap.hpp"
+#include "../utils/random.hpp"
+
+#define TILE_SIZE 15.0f
+#define PATTERN_SIZE 10
+
+using Clock = std::chrono::steady_clock;
+
+auto make_map(int size) -> std::vector<char> {
+	controler::WaveFuncMap wave_map(PATTERN_SIZE, 2);
+	wave_map.set_seed(1);
+	const auto pattern = wave_map.generate();
+	std::vector<char> char_map(size * size);
+	for(int z = 0; z < size; z++){
+		for(int x = 0; x < size; x++){
+			char_map[x + z * size] = pattern[(x % PATTERN_SIZE) + (z % PATTERN_SIZE) * PATTERN_SIZE];
+		}
+	}
+	return char_map;
+}
+
+inline auto tile_center(int tile, int size) -> glm::vec4 {
+	return glm::vec4((tile % size) * 2 * TILE_SIZE + TILE_SIZE / 2, 0.0f, (tile / size) * 2 * TILE_SIZE + TILE_SIZE / 2, 1.0f);
+}
+
+//pairs of tiles that are not houses
+auto make_queries(const std::vector<char> &char_map, int size, int count) -> std::vector<std::pair<int, int>> {
+	utils::Random random(11);
+	std::vector<int> free_tiles;
+	for(int tile = 0; tile < size * size; tile++){
+		if(char_map[tile] != '#'){
+			free_tiles.push_back(tile);
+		}
+	}
+	std::vector<std::pair<int, int>> queries;
+	for(int i = 0; i < count; i++){
+		const int from = free_tiles[random.below(free_tiles.size())];
+		const int to = free_tiles[random.below(free_tiles.size())];
+		queries.push_back(std::make_pair(from, to));
+	}
+	return queries;
+}
+
+//walks the stretch a unit at a time, looking at the tile under each point
+auto crosses_house(const controler::RoadPlanner &planner, const std::vector<char> &char_map,
+	const glm::vec4 &a, const glm::vec4 &b) -> bool {
+	const float dx = b.x - a.x;
+	const float dz = b.z - a.z;
+	const int steps = std::max(1, static_cast<int>(ceilf(sqrtf(dx*dx + dz*dz))));
+	for(int i = 0; i <= steps; i++){
+		const float t = i / static_cast<float>(steps);
+		if(char_map[planner.tile_of(a.x + dx * t, a.z + dz * t)] == '#'){
+			return true;
+		}
+	}
+	return false;
+}
+
+int main(int argc, char** argv){
+	const int query_count = argc > 1 ? std::atoi(argv[1]) : 200;
+	std::printf("size,tiles,nodes,build_ms,queries,cold_us,cached_us,cache_hits,found,unreachable,wrong\n");
+	const int sizes[] = {10, 100, 1000};
+	for(int size : sizes){
+		const auto char_map = make_map(size);
+		const auto queries = make_queries(char_map, size, query_count);
+
+		controler::RoadPlanner planner(static_cast<std::size_t>(query_count));
+		auto start = Clock::now();
+		planner.build(char_map, size, TILE_SIZE);
+		const double build_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		std::vector<glm::vec4> waypoints;
+		std::vector<bool> found(queries.size());
+		start = Clock::now();
+		for(size_t i = 0; i < queries.size(); i++){
+			found[i] = planner.find_path(tile_center(queries[i].first, size), tile_center(queries[i].second, size), waypoints);
+		}
+		const double cold_us = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / queries.size();
+
+		const long hits_before = planner.get_cache().get_hits();
+		start = Clock::now();
+		for(const auto &query : queries){
+			planner.find_path(tile_center(query.first, size), tile_center(query.second, size), waypoints);
+		}
+		const double cached_us = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / queries.size();
+		const long cache_hits = planner.get_cache().get_hits() - hits_before;
+
+		//checked apart from the timed runs, the flow field to each goal says if there is a way at all
+		int found_count = 0, unreachable = 0, wrong = 0;
+		controler::FlowField field;
+		field.build(char_map, size, TILE_SIZE);
+		for(size_t i = 0; i < queries.size(); i++){
+			const auto from = tile_center(queries[i].first, size);
+			const auto to = tile_center(queries[i].second, size);
+			if(found[i]){
+				found_count++;
+				planner.find_path(from, to, waypoints);
+				auto last = from;
+				for(const auto &point : waypoints){
+					if(crosses_house(planner, char_map, last, point)){
+						wrong++;
+						break;
+					}
+					last = point;
+				}
+				continue;
+			}
+			field.update(to);
+			if(field.get_cost(queries[i].first) == controler::FlowField::UNREACHABLE){
+				unreachable++;
+			}else{
+				wrong++;
+			}
+		}
+		std::printf("%d,%d,%d,%.2f,%d,%.2f,%.2f,%ld,%d,%d,%d\n", size, size * size, planner.get_node_count(), build_ms,
+			static_cast<int>(queries.size()), cold_us, cached_us, cache_hits, found_count, unreachable, wrong);
+	}
+	return 0;
+}
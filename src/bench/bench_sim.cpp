@@ -0,0 +1,142 @@
+/*
+	Runs the whole game logic headless: map generation, spawning, the enemies, collisions and game events.
+	There is no window or GL context, the player is moved by a scripted input or by a recording of the game
+	(bin/main --record file), which plays back the exact session with its seed.
+	Prints the average time of a tick for each window of ticks, as the zombies pile up,
+	how many zombies got a full update (not only the level of detail drift) per tick
+	how many collision probes were blocked per tick, with the crowd steering on or off (crowd 0),
+	and the time the zombies spent thinking per tick against the budget of the AiScheduler (0 for no limit).
+	usage: bin/bench_sim [ticks] [max enemies] [spawn interval in ticks] [window] [recording|-] [crowd] [ai budget in us]
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <algorithm>
+
+#include "../controlers/simulation.hpp"
+#include "../controlers/input.hpp"
+#include "../controlers/replay.hpp"
+#include "../entities/entity.hpp"
+#include "../entities/registry.hpp"
+
+//the same map and player the game sets up in main
+#define MAP_SIZE 10
+#define TILE_SIZE 15.0f
+
+using Clock = std::chrono::steady_clock;
+
+auto make_player(bool immortal) -> std::shared_ptr<entity::Player> {
+	std::shared_ptr<entity::Player> player(new entity::Player(glm::vec4(0,0,-6,1), nullptr, nullptr));
+	player->set_bbox_type(entity::BBoxType::Cylinder);
+	player->set_base_direction(glm::vec4(0.0f,0.0f,1.0f,0.0f));
+	player->set_bbox_size(1.0f,1.0f,1.0f);
+	player->set_speed(0.2f);
+	//a bench doesn't end because the zombies got the player
+	if(immortal){
+		player->set_life_points(1 << 30);
+	}
+	return player;
+}
+
+//walks in a square, with a few stops
+auto make_script() -> controler::ScriptedInput {
+	controler::ScriptedInput script;
+	const entity::PressedKeys forward{true,false,false,false};
+	const entity::PressedKeys none{false,false,false,false};
+	for(int i = 0; i < 4; i++){
+		script.add_step(180, forward, i * PI / 2);
+		script.add_step(30, none, i * PI / 2);
+	}
+	return script;
+}
+
+int main(int argc, char** argv){
+	const int ticks = argc > 1 ? std::atoi(argv[1]) : 4000;
+	const int max_enemies = argc > 2 ? std::atoi(argv[2]) : 500;
+	const float spawn_interval = argc > 3 ? static_cast<float>(std::atof(argv[3])) : 5.0f;
+	const int window = argc > 4 ? std::atoi(argv[4]) : 1000;
+	const char *recording = argc > 5 && std::strcmp(argv[5], "-") != 0 ? argv[5] : nullptr;
+	const bool crowd = argc > 6 ? std::atoi(argv[6]) != 0 : true;
+	const long ai_budget = argc > 7 ? std::atol(argv[7]) : 1000;
+
+	std::unique_ptr<controler::Generator> generator(new controler::Generator(MAP_SIZE, TILE_SIZE));
+	const float world_size = generator->get_map_size() * 2 * generator->get_tile_size();
+	std::unique_ptr<entity::Registry> registry(new entity::Registry());
+	std::unique_ptr<controler::CollisionMap> collision_map(
+		new controler::CollisionMap(*registry, world_size, world_size, 20, 20, controler::BroadPhaseType::Grid));
+
+	const bool replaying = recording != nullptr;
+	controler::Simulation sim(std::move(registry), std::move(collision_map), std::move(generator), make_player(!replaying));
+	sim.set_use_components(true);
+	if(!crowd){
+		sim.set_crowd_settings(controler::CrowdSettings{4.0f, 0.0f, 0.0f, 6.0f, 0.0f});
+	}
+
+	std::unique_ptr<controler::InputSource> input(new controler::ScriptedInput(make_script()));
+	//ticks per second, the ticks are in the units of the game like the GameLoop passes them
+	float tick_rate = GAME_TIME_UNITS_PER_SECOND;
+	if(replaying){
+		std::unique_ptr<controler::InputReplayer> replay(new controler::InputReplayer(recording));
+		sim.set_seed(replay->get_seed());
+		tick_rate = replay->get_tick_rate();
+		std::printf("replaying %s, seed %llu, %.0f ticks per second\n", recording,
+			static_cast<unsigned long long>(replay->get_seed()), tick_rate);
+		input = std::move(replay);
+		//the same setup main does, so the ticks are the ones of the recorded session
+		const int extra_threads = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0);
+		sim.set_enemy_update_mode(controler::EnemyUpdateMode::Parallel, extra_threads);
+		sim.set_ai_settings(controler::AiSettings::replayable());
+	}else{
+		sim.set_seed(0);
+		sim.set_spawn_settings(controler::SpawnSettings{spawn_interval, max_enemies, 150.0f});
+		sim.set_ai_settings(controler::AiSettings{ai_budget, 0, 64});
+	}
+	const float tick_delta = GAME_TIME_UNITS_PER_SECOND / tick_rate;
+
+	std::printf("tick,enemies,ns_per_tick,full_updates,blocked_per_tick,ai_budget_us,ai_us_per_tick,ai_max_us,thinks_per_tick,ai_pending,score,rounds\n");
+	int rounds = 1;
+	//a recording starts with the click on play
+	input->round_event(controler::RoundEvent::Start);
+	sim.start_round();
+	long full_updates = 0;
+	double ai_us = 0.0;
+	double ai_max_us = 0.0;
+	long thinks = 0;
+	long blocked = sim.get_collision_map().get_total_stats().hits;
+	auto start = Clock::now();
+	for(int t = 1; t <= ticks; t++){
+		const auto result = sim.tick(tick_delta, input->next());
+		full_updates += sim.get_enemy_lod().get_full_updates();
+		const auto &ai = sim.get_ai_stats();
+		ai_us += ai.used_us;
+		ai_max_us = std::max(ai_max_us, ai.used_us);
+		thinks += ai.thinks;
+		if(result != entity::GameEventTypes::None){
+			//the player got to the car, same as retry in the menu, a recording ends where the session was closed
+			if(input->round_event(controler::RoundEvent::Start) == controler::RoundEvent::Exit){
+				break;
+			}
+			sim.clear_round();
+			sim.start_round();
+			rounds++;
+		}
+		if(t % window == 0){
+			const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+			const long total_blocked = sim.get_collision_map().get_total_stats().hits;
+			std::printf("%d,%d,%.0f,%.1f,%.1f,%ld,%.1f,%.1f,%.1f,%d,%d,%d\n", t, static_cast<int>(sim.get_enemies().size()), ns / window,
+				full_updates / static_cast<double>(window), (total_blocked - blocked) / static_cast<double>(window),
+				sim.get_ai_stats().budget_us, ai_us / window, ai_max_us, thinks / static_cast<double>(window),
+				sim.get_ai_stats().pending, sim.get_score(), rounds);
+			full_updates = 0;
+			ai_us = 0.0;
+			ai_max_us = 0.0;
+			thinks = 0;
+			blocked = total_blocked;
+			start = Clock::now();
+		}
+	}
+	return 0;
+}
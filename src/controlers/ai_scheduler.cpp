@@ -0,0 +1,113 @@
+#include "ai_scheduler.hpp"
+
+#include <algorithm>
+
+namespace controler{
+	AiScheduler::AiScheduler(AiSettings settings): settings(settings) {}
+
+	auto AiScheduler::state_of(entity::Handle enemy) -> State& {
+		if(enemy.index >= states.size()){
+			states.resize(enemy.index + 1);
+		}
+		auto &state = states[enemy.index];
+		if(state.generation != enemy.generation){
+			state = State();
+			state.generation = enemy.generation;
+		}
+		return state;
+	}
+
+	auto AiScheduler::request(entity::Handle enemy) -> void {
+		auto &state = state_of(enemy);
+		if(state.queued){
+			return;
+		}
+		state.queued = true;
+		state.ticket = ++next_ticket;
+		queue.push_back(Request{enemy, state.ticket});
+	}
+
+	auto AiScheduler::reset(entity::Handle enemy) -> void {
+		//the entry stays in the queue, take_batch skips it since its ticket is no longer the one of the state
+		auto &state = state_of(enemy);
+		state.queued = false;
+		state.decided = false;
+		state.ticket = 0;
+		state.decision = glm::vec4(0.0f);
+	}
+
+	auto AiScheduler::clear() -> void {
+		states.clear();
+		queue.clear();
+		next_ticket = 0;
+		//the cost of a think outlives the round, the slices of the next one start sized
+		const double think_us = stats.think_us;
+		stats = AiStats();
+		stats.think_us = think_us;
+	}
+
+	auto AiScheduler::take_batch(int limit) -> void {
+		batch.clear();
+		while(!queue.empty() && static_cast<int>(batch.size()) < limit){
+			const auto request = queue.front();
+			queue.pop_front();
+			const auto enemy = request.enemy;
+			if(enemy.index >= states.size()){
+				continue;
+			}
+			auto &state = states[enemy.index];
+			if(state.generation != enemy.generation || !state.queued || state.ticket != request.ticket){
+				continue;
+			}
+			state.queued = false;
+			batch.push_back(enemy);
+		}
+	}
+
+	auto AiScheduler::store_batch() -> void {
+		for(size_t i = 0; i < batch.size(); i++){
+			auto &state = states[batch[i].index];
+			state.decision = decisions[i];
+			state.decided = true;
+		}
+		stats.thinks += static_cast<int>(batch.size());
+	}
+
+	auto AiScheduler::next_slice(double used_us) const -> int {
+		int limit = std::max(settings.slice, 1);
+		if(settings.max_thinks > 0){
+			limit = std::min(limit, settings.max_thinks - stats.thinks);
+		}
+		if(settings.budget_us <= 0){
+			return limit;
+		}
+		//nothing measured yet, a few thinks give the first cost
+		if(stats.think_us == 0.0){
+			return std::min(limit, 4);
+		}
+		//the thinks of a packed crowd cost more than the average, the last slice tells when it is in one
+		const double cost = std::max(stats.think_us, last_think_us);
+		const int fit = static_cast<int>((settings.budget_us - used_us) / cost);
+		//one think always goes in a tick, so the queue moves on even with a budget too small for it
+		return std::min(limit, std::max(fit, stats.thinks == 0 ? 1 : 0));
+	}
+
+	auto AiScheduler::measure_think(double slice_us, int count) -> void {
+		const double cost = slice_us / count;
+		last_think_us = cost;
+		//moving average, a slow slice (a thread switch) doesn't shrink the next ticks by itself
+		stats.think_us = stats.think_us == 0.0 ? cost : stats.think_us * 0.8 + cost * 0.2;
+	}
+
+	auto AiScheduler::decision(entity::Handle enemy, glm::vec4 &out) const -> bool {
+		if(enemy.index >= states.size()){
+			return false;
+		}
+		const auto &state = states[enemy.index];
+		if(state.generation != enemy.generation || !state.decided){
+			return false;
+		}
+		out = state.decision;
+		return true;
+	}
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+#include <glm/vec4.hpp>
+
+#include "../entities/handle.hpp"
+
+namespace controler{
+	struct AiSettings{
+		long budget_us; //time for the thinks of a tick, 0 for no time limit
+		int max_thinks; //thinks in a tick, 0 for no limit
+		int slice;      //most thinks handed to the think function at once, fewer when the budget left can't fit them
+
+		//the same thinks on every run, for recordings and replays, the time doesn't decide anything
+		static inline auto replayable() -> AiSettings { return AiSettings{0, 256, 32}; }
+	};
+	//of the last tick, for profiling
+	struct AiStats{
+		long budget_us = 0;
+		double used_us = 0.0;
+		int thinks = 0;
+		int pending = 0;       //requests left in the queue for the next ticks
+		long over_budget = 0;  //ticks since the last clear that went past the budget
+		long total_thinks = 0;
+		double think_us = 0.0; //measured cost of a think, what the slices are sized by
+	};
+	/*
+	Spreads the thinking of the zombies over the ticks. Each zombie asks for a think, the requests are
+	served in the order they came (round-robin, since a zombie only asks again after it was served)
+	until the budget of the tick runs out, the rest waits for the next tick.
+	Between thinks a zombie keeps going by its last decision, so the cost of a tick doesn't grow with the horde.
+		AiScheduler ai(AiSettings{1000, 0, 32});
+		ai.request(handle);
+		ai.run([&](const entity::Handle *handles, int count, glm::vec4 *decisions){ ... });
+		glm::vec4 heading;
+		if(ai.decision(handle, heading)){ ... }
+	The state is kept by the slot of the handle, call reset when an enemy is (re)placed or taken out.
+	*/
+	class AiScheduler{
+		public:
+			using Clock = std::chrono::steady_clock;
+
+			AiScheduler(AiSettings settings);
+
+			//queues a think for the enemy, nothing if it already has one queued
+			auto request(entity::Handle enemy) -> void;
+			//drops the decision and the queued think of the enemy
+			auto reset(entity::Handle enemy) -> void;
+			auto clear() -> void;
+
+			//think(handles, count, decisions) writes a decision for each handle, the calls can split the work
+			//between threads, each decision is only written by the one that thinks it
+			template<class Think>
+			auto run(Think &&think) -> void {
+				const auto start = Clock::now();
+				stats.thinks = 0;
+				stats.budget_us = settings.budget_us;
+				while(!queue.empty()){
+					int limit = next_slice(elapsed_us(start));
+					if(limit <= 0){
+						break;
+					}
+					take_batch(limit);
+					if(!batch.empty()){
+						const auto slice_start = Clock::now();
+						decisions.resize(batch.size());
+						think(batch.data(), static_cast<int>(batch.size()), decisions.data());
+						store_batch();
+						measure_think(elapsed_us(slice_start), static_cast<int>(batch.size()));
+					}
+					if(settings.budget_us > 0 && elapsed_us(start) >= settings.budget_us){
+						break;
+					}
+				}
+				stats.used_us = elapsed_us(start);
+				stats.pending = static_cast<int>(queue.size());
+				stats.total_thinks += stats.thinks;
+				if(settings.budget_us > 0 && stats.used_us > settings.budget_us){
+					stats.over_budget++;
+				}
+			}
+
+			//the last decision of the enemy in out, false if it didn't think since it was (re)placed
+			auto decision(entity::Handle enemy, glm::vec4 &out) const -> bool;
+
+			inline auto get_settings() const -> const AiSettings& { return settings; }
+			inline auto set_settings(AiSettings s) -> void { settings = s; }
+			inline auto get_stats() const -> const AiStats& { return stats; }
+		private:
+			struct State{
+				uint32_t generation = 0; //of the handle it belongs to, a mismatch means a new enemy
+				uint32_t ticket = 0;     //of its request in the queue, an entry with another one is stale
+				bool queued = false;
+				bool decided = false;
+				glm::vec4 decision = glm::vec4(0.0f);
+			};
+			struct Request{
+				entity::Handle enemy;
+				uint32_t ticket;
+			};
+			auto state_of(entity::Handle enemy) -> State&;
+			//pops up to limit requests that are still wanted into batch
+			auto take_batch(int limit) -> void;
+			auto store_batch() -> void;
+			//thinks the next slice can take, 0 when the budget is spent
+			auto next_slice(double used_us) const -> int;
+			//updates the cost of a think with a slice that took slice_us
+			auto measure_think(double slice_us, int count) -> void;
+			inline auto elapsed_us(Clock::time_point start) const -> double {
+				return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+			}
+
+			AiSettings settings;
+			AiStats stats;
+			std::vector<State> states; //by index of the handle
+			std::deque<Request> queue;
+			uint32_t next_ticket = 0;
+			double last_think_us = 0.0; //cost of a think in the last slice
+			std::vector<entity::Handle> batch;
+			std::vector<glm::vec4> decisions;
+	};
+}
@@ -1,49 +1,82 @@
 #include "collision.hpp"
 
 #include <iostream>
+#include <algorithm>
+#include <cassert>
 
 namespace controler{
-	SpacialHash::SpacialHash(float cell_x, float cell_y):
-		cell_x(cell_x), cell_y(cell_y){}
+	//the 3x3 block of cells around the key, the only place where a collision can happen
+	auto NeighborIter::next() -> GridCell* {
+		while(neighbor < 9){
+			const int n = neighbor++;
+			if(!(mask & (1 << n))){
+				continue;
+			}
+			const auto local = std::make_pair(key.first + (n / 3) - 1, key.second + (n % 3) - 1);
+			auto cell = map->get_cell(local);
+			if(cell != nullptr && !cell->empty()){
+				return cell;
+			}
+		}
+		return nullptr;
+	}
 
-	auto SpacialHash::make_key(Entt elem) const -> std::pair<int,int>{
-		const auto cords = elem->get_cords();
-		const int center_x = static_cast<int>(floorf(cords.x/cell_x));
-		const int center_y = static_cast<int>(floorf(cords.y/cell_y));
-		return std::make_pair(center_x,center_y);
+	//the slot of each element is kept in the entity, so it can be found without searching the cell
+	inline auto slot_push(GridCell &cell, Entt elem) -> void {
+		elem->set_cell_slot(static_cast<int>(cell.size()));
+		cell.push_back(elem);
+	}
+	//removes by swaping with the last element, the order inside a cell doesn't matter
+	inline auto swap_remove(GridCell &cell, Entt elem) -> int {
+		int slot = elem->get_cell_slot();
+		if(slot < 0 || slot >= static_cast<int>(cell.size()) || cell[slot] != elem){
+			//stale slot, fallback to the search
+			auto it = std::find(cell.begin(), cell.end(), elem);
+			if(it == cell.end()){
+				return 0;
+			}
+			slot = static_cast<int>(it - cell.begin());
+		}
+		if(slot != static_cast<int>(cell.size()) - 1){
+			cell[slot] = cell.back();
+			cell[slot]->set_cell_slot(slot);
+		}
+		cell.pop_back();
+		elem->set_cell_slot(-1);
+		return 1;
+	}
+
+	/*****************************
+		SpacialHash implementation
+	******************************/
+	SpacialHash::SpacialHash(float cell_u, float cell_v, HashPlane plane):
+		cell_u(cell_u), cell_v(cell_v), plane(plane){}
+
+	auto SpacialHash::make_key(const glm::vec4 &cords) const -> std::pair<int,int>{
+		const float v = plane == HashPlane::XZ ? cords.z : cords.y;
+		const int center_u = static_cast<int>(floorf(cords.x/cell_u));
+		const int center_v = static_cast<int>(floorf(v/cell_v));
+		return std::make_pair(center_u,center_v);
 	}
 
 	auto SpacialHash::insert(std::pair<int,int> key, Entt elem) -> void {
-		map[key].push_front(elem);
+		slot_push(map[key], elem);
 	}
 
 	auto SpacialHash::remove(std::pair<int,int> key, Entt elem) -> int {
-		if(!map.count(key)){
+		auto it = map.find(key);
+		if(it == map.end()){
 			return 0;
 		}
-		map[key].remove(elem);
-		return 1;
+		return swap_remove(it->second, elem);
 	}
 
-	auto SpacialHash::get_cell(std::pair<int,int> key) -> std::forward_list<Entt>* {
-		if(map.count(key) == 0){
+	auto SpacialHash::get_cell(std::pair<int,int> key) -> GridCell* {
+		auto it = map.find(key);
+		if(it == map.end()){
 			return nullptr;
 		}
-		return &map[key];
-	}
-
-	auto SpacialHash::get_quadrant(std::pair<int,int> key) -> std::vector<std::forward_list<Entt>*>{
-		std::vector<std::forward_list<Entt>*> out;
-		for(int i = -1; i < 2; i++){
-			for(int j = -1; j < 2; j++){
-				auto local = std::make_pair(key.first + i, key.second + j);
-				auto list = get_cell(local);
-				if(list != nullptr){
-					out.push_back(list);
-				}
-			}
-		}
-		return out;
+		return &it->second;
 	}
 
 	auto SpacialHash::clear() -> void {
@@ -51,164 +84,420 @@ namespace controler{
 	}
 
 	auto SpacialHash::log() const -> void {
-		std::cout << "cell size x: " << cell_x << " y: " << cell_y << std::endl;
+		std::cout << "cell size x: " << cell_u << (plane == HashPlane::XZ ? " z: " : " y: ") << cell_v << std::endl;
 	}
 
-	CollisionMap::CollisionMap(float max_width, float max_depth, float mover_cell_grain, float obj_cell_grain):
-	max_width(max_width),max_depth(max_depth),mover_cell_grain(mover_cell_grain),obj_cell_grain(obj_cell_grain),
-		mover_map(SpacialHash(max_width/mover_cell_grain, max_depth/mover_cell_grain)),
-		obj_map(SpacialHash(max_width/obj_cell_grain, max_depth/obj_cell_grain))
-	{
-		//mover_map.log();
-		//obj_map.log();
-	}
+	/*****************************
+		DenseGrid implementation
+	******************************/
+	DenseGrid::DenseGrid(float min_x, float min_z, float max_x, float max_z, float cell_x, float cell_z):
+		min_x(min_x), min_z(min_z), cell_x(cell_x), cell_z(cell_z),
+		cols(std::max(1, static_cast<int>(ceilf((max_x - min_x)/cell_x)))),
+		rows(std::max(1, static_cast<int>(ceilf((max_z - min_z)/cell_z)))),
+		cells(cols * rows){}
 
-	auto CollisionMap::clear() -> void {
-		mover_map.clear();
-		obj_map.clear();
+	auto DenseGrid::make_key(const glm::vec4 &cords) const -> std::pair<int,int>{
+		const int x = static_cast<int>(floorf((cords.x - min_x)/cell_x));
+		const int z = static_cast<int>(floorf((cords.z - min_z)/cell_z));
+		//clamping keeps neighbors as neighbors, so nothing is lost outside the bounds
+		return std::make_pair(std::min(std::max(x, 0), cols - 1), std::min(std::max(z, 0), rows - 1));
 	}
 
-	auto CollisionMap::insert_obj(Entt obj) -> int {
-		auto c_key = obj_map.make_key(obj);
-		obj_map.insert(c_key, obj);
-		return 1;
-	}
-	auto CollisionMap::remove_obj(Entt obj) -> int {
-		auto key = obj_map.make_key(obj);
-		return mover_map.remove(key,obj);
+	auto DenseGrid::insert(std::pair<int,int> key, Entt elem) -> void {
+		assert(inside(key));
+		slot_push(cells[key.first + key.second * cols], elem);
 	}
-	//for the movable map
-	auto CollisionMap::insert_mover(Entt entity) -> int {
-		auto key = mover_map.make_key(entity);
-		mover_map.insert(key,entity);
-		return 1;
-	}
-	auto CollisionMap::remove_mover(Entt entity) -> int {
-		auto key = mover_map.make_key(entity);
-		return mover_map.remove(key,entity);
-	}
-	auto CollisionMap::box_to_box_collision(Entt target, Entt geometry, const glm::vec4 future_pos) const -> bool{
-
-		const auto geo_cords = geometry->get_cords();
-		const float box_x = geometry->get_x_radius();
-		const float box_z = geometry->get_z_radius();
 
-		const float x_radius = target->get_x_radius();
-		const float z_radius = target->get_z_radius();
-
-		//solution taken from stackoverflow https://stackoverflow.com/a/62852710
-		return std::max(geo_cords.x - box_x, future_pos.x - x_radius) < std::min(geo_cords.x + box_x, future_pos.x + x_radius) &&
-		std::max(geo_cords.z - box_z, future_pos.z - z_radius) < std::min(geo_cords.z + box_z, future_pos.z + z_radius);
+	auto DenseGrid::remove(std::pair<int,int> key, Entt elem) -> int {
+		if(!inside(key)){
+			return 0;
+		}
+		return swap_remove(cells[key.first + key.second * cols], elem);
 	}
-	auto CollisionMap::cilinder_to_box_collision(Entt target, Entt geometry, const glm::vec4 future_pos) const -> bool{
-		const auto center2geometry = geometry->get_cords() - future_pos;
 
-		const float x_radius = target->get_x_radius();
-		const float z_radius = target->get_z_radius();
-		
-		const float co = center2geometry.z;
-		const float ca = center2geometry.x;
-		const float hipotenuse = sqrtf(co*co + ca*ca);
-		
-		const float rx = x_radius * (ca / hipotenuse);
-		const float rz = z_radius * (co / hipotenuse);
+	auto DenseGrid::get_cell(std::pair<int,int> key) -> GridCell* {
+		if(!inside(key)){
+			return nullptr;
+		}
+		return &cells[key.first + key.second * cols];
+	}
 
-		const glm::vec4 boundry_point(future_pos.x + rx, future_pos.y, future_pos.z + rz, 1);
+	auto DenseGrid::clear() -> void {
+		//keeps the capacity of each cell, so the next round doesn't allocate again
+		for(auto &cell : cells){
+			cell.clear();
+		}
+	}
 
-		//std::cout << "cos(" << ca << "/" << hipotenuse << ") = " << cosf(ca/hipotenuse) << std::endl;
-		//std::cout << "rx: " << rx << " = " << x_radius << "*" << cosf(ca/hipotenuse) << std::endl;
-		//std::cout << "Boundry Point: " << boundry_point.x << " " << boundry_point.z << std::endl;
+	auto DenseGrid::log() const -> void {
+		std::cout << "grid " << cols << "x" << rows << " cell size x: " << cell_x << " z: " << cell_z << std::endl;
+	}
 
-		const auto geo_cords = geometry->get_cords();
-		const float box_x = geometry->get_x_radius();
-		const float box_z = geometry->get_z_radius();
+	/*****************************
+		CollisionMap implementation
+	******************************/
+	CollisionMap::CollisionMap(const entity::Registry &registry, float max_width, float max_depth, float mover_cell_grain, float obj_cell_grain, BroadPhaseType type):
+	registry(registry), max_width(max_width),max_depth(max_depth),mover_cell_grain(mover_cell_grain),obj_cell_grain(obj_cell_grain),type(type),
+		obj_map(make_broadphase(obj_cell_grain)),
+		mover_map(make_broadphase(mover_cell_grain)),
+		trigger_map(make_broadphase(mover_cell_grain))
+	{
+		//mover_map->log();
+		//obj_map->log();
+	}
 
-		return std::max(geo_cords.x - box_x, boundry_point.x) == std::min(geo_cords.x + box_x, boundry_point.x) &&
-			   std::max(geo_cords.z - box_z, boundry_point.z) == std::min(geo_cords.z + box_z, boundry_point.z);
+	auto CollisionMap::make_broadphase(float cell_grain) const -> std::unique_ptr<BroadPhase> {
+		const float cell_x = max_width/cell_grain;
+		const float cell_z = max_depth/cell_grain;
+		switch (type){
+		case BroadPhaseType::Grid:
+			return std::unique_ptr<BroadPhase>(new DenseGrid(0.0f, 0.0f, max_width, max_depth, cell_x, cell_z));
+		case BroadPhaseType::Hash:
+		default:
+			return std::unique_ptr<BroadPhase>(new SpacialHash(cell_x, cell_z, HashPlane::XZ));
+		}
 	}
-	auto CollisionMap::box_to_cilinder_collision(Entt target, Entt geometry, const glm::vec4 future_pos) const -> bool{
-		const float x_radius = target->get_x_radius();
-		const float z_radius = target->get_z_radius();
-		
-		const auto geo_cords = geometry->get_cords();
-		const auto geometry2center = future_pos - geo_cords;
 
-		const float ca = geometry2center.x;
-		const float co = geometry2center.z;
-		const float hipotenuse = sqrtf(co*co + ca*ca);
-		
-		const float rx = x_radius * (ca / hipotenuse);
-		const float rz = z_radius * (co / hipotenuse);
+	auto CollisionMap::clear() -> void {
+		mover_map->clear();
+		obj_map->clear();
+		trigger_map->clear();
+		static_map.clear();
+	}
 
-		const glm::vec4 geo_boundry_point(geo_cords.x + rx, geo_cords.y, geo_cords.z + rz, 1);
+	auto CollisionMap::build_static(const std::vector<char> &char_map, int map_size, float tile_size,
+		const std::vector<entity::Handle> &walls) -> void {
+		std::vector<Entt> entities;
+		entities.reserve(walls.size());
+		for(const auto wall : walls){
+			if(auto e = registry.get(wall)){
+				entities.push_back(e);
+			}
+		}
+		//a quarter of a tile is fine enough for the house footprints
+		const auto left_out = static_map.build(char_map, map_size, tile_size, entities, tile_size / 4);
+		for(auto wall : left_out){
+			obj_map->insert(obj_map->make_key(wall), wall);
+		}
+	}
 
-		return std::max(future_pos.x - x_radius, geo_boundry_point.x) == std::min(future_pos.x + x_radius, geo_boundry_point.x) &&
-			   std::max(future_pos.z - z_radius, geo_boundry_point.z) == std::min(future_pos.z + z_radius, geo_boundry_point.z);
+	auto CollisionMap::insert_obj(entity::Handle handle) -> int {
+		const auto obj = registry.get(handle);
+		if(obj == nullptr){
+			return 0;
+		}
+		auto c_key = obj_map->make_key(obj);
+		obj_map->insert(c_key, obj);
+		return 1;
+	}
+	auto CollisionMap::remove_obj(entity::Handle handle) -> int {
+		const auto obj = registry.get(handle);
+		if(obj == nullptr){
+			return 0;
+		}
+		if(static_map.remove(obj)){
+			return 1;
+		}
+		auto key = obj_map->make_key(obj);
+		return obj_map->remove(key,obj);
 	}
-	auto CollisionMap::cilinder_to_cilinder_collision(Entt target, Entt geometry, const glm::vec4 future_pos) const -> bool{
-		const float x_radius = target->get_x_radius();
-		const float z_radius = target->get_z_radius();
-		
-		const auto center2geometry = geometry->get_cords() - future_pos;
-		
-		const float co = center2geometry.z;
-		const float ca = center2geometry.x;
-		const float hipotenuse = sqrtf(co*co + ca*ca);
-		
-		const float rx = x_radius * (ca / hipotenuse);
-		const float rz = z_radius * (co / hipotenuse);
+	//for the movable map
+	auto CollisionMap::insert_mover(entity::Handle handle) -> int {
+		const auto entity = registry.get(handle);
+		if(entity == nullptr){
+			return 0;
+		}
+		auto key = mover_map->make_key(entity);
+		mover_map->insert(key,entity);
+		return 1;
+	}
+	auto CollisionMap::remove_mover(entity::Handle handle) -> int {
+		const auto entity = registry.get(handle);
+		if(entity == nullptr){
+			return 0;
+		}
+		auto key = mover_map->make_key(entity);
+		return mover_map->remove(key,entity);
+	}
+	auto CollisionMap::insert_trigger(entity::Handle handle) -> int {
+		const auto trigger = registry.get(handle);
+		if(trigger == nullptr){
+			return 0;
+		}
+		auto key = trigger_map->make_key(trigger);
+		trigger_map->insert(key,trigger);
+		return 1;
+	}
+	auto CollisionMap::remove_trigger(entity::Handle handle) -> int {
+		const auto trigger = registry.get(handle);
+		if(trigger == nullptr){
+			return 0;
+		}
+		auto key = trigger_map->make_key(trigger);
+		return trigger_map->remove(key,trigger);
+	}
+	auto CollisionMap::relocate(entity::Handle handle, const glm::vec4 &old_pos, const glm::vec4 &new_pos) -> int {
+		const auto entity = registry.get(handle);
+		if(entity == nullptr){
+			return 0;
+		}
+		const auto old_key = mover_map->make_key(old_pos);
+		const auto new_key = mover_map->make_key(new_pos);
+		if(old_key == new_key){
+			return 0;
+		}
+		//not in the map (never inserted or already removed), inserting it would add one it doesn't know about
+		if(mover_map->remove(old_key, entity) == 0){
+			return 0;
+		}
+		mover_map->insert(new_key, entity);
+		return 1;
+	}
+	auto CollisionMap::gather(BroadPhase &map, const entity::Entity *entity, const glm::vec4 &from, const glm::vec4 &to, QueryContext &context) const -> void {
+		auto &batch = context.batch;
+		const auto low = map.make_key(glm::vec4(std::min(from.x, to.x), std::min(from.y, to.y), std::min(from.z, to.z), 1.0f));
+		const auto high = map.make_key(glm::vec4(std::max(from.x, to.x), std::max(from.y, to.y), std::max(from.z, to.z), 1.0f));
+		const int before = batch.size();
+		if(low == high){
+			auto neighbors = map.get_quadrant(low);
+			while(auto prox = neighbors.next()){
+				context.stats.cells_visited++;
+				for(const auto candidate : *prox){
+					//movers stay in the map while they query
+					if(candidate != entity && entity->collides_with(*candidate)){
+						batch.push(candidate);
+					}
+				}
+			}
+		}else{
+			//long paths cross more than one cell, takes the whole block around them
+			for(int u = low.first - 1; u <= high.first + 1; u++){
+				for(int v = low.second - 1; v <= high.second + 1; v++){
+					auto prox = map.get_cell(std::make_pair(u, v));
+					if(prox == nullptr || prox->empty()){
+						continue;
+					}
+					context.stats.cells_visited++;
+					for(const auto candidate : *prox){
+						if(candidate != entity && entity->collides_with(*candidate)){
+							batch.push(candidate);
+						}
+					}
+				}
+			}
+		}
+		context.stats.candidates_tested += batch.size() - before;
+	}
+	auto CollisionMap::gather_static(const entity::Entity *entity, const glm::vec4 &from, const glm::vec4 &to, QueryContext &context) const -> void {
+		if(static_map.empty() || !(entity->get_collision_mask() & entity::LAYER_SOLID)){
+			return;
+		}
+		const float rx = entity->get_x_radius();
+		const float rz = entity->get_z_radius();
+		context.static_found.clear();
+		static_map.walls_in(std::min(from.x, to.x) - rx, std::min(from.z, to.z) - rz,
+			std::max(from.x, to.x) + rx, std::max(from.z, to.z) + rz, context.static_found);
+		for(auto wall : context.static_found){
+			context.batch.push(wall);
+		}
+		context.stats.candidates_tested += context.static_found.size();
+	}
+	auto CollisionMap::merge_stats(const QueryStats &stats, long queries) -> void {
+		query_count += queries;
+		total_stats.cells_visited += stats.cells_visited;
+		total_stats.candidates_tested += stats.candidates_tested;
+		total_stats.hits += stats.hits;
+	}
+	auto CollisionMap::colide_direction(entity::Handle handle, const glm::vec4 direction) -> entity::Handle {
+		context.stats = QueryStats();
+		const auto entity = registry.get(handle);
+		if(entity == nullptr){
+			return entity::Handle();
+		}
 
-		const glm::vec4 boundry_point(future_pos.x + rx, future_pos.y, future_pos.z + rz, 1);
+		const auto cords = entity->get_cords();
+		const auto future_pos = cords + (direction * entity->get_speed());
+		const auto probe = make_probe(*entity, future_pos);
 
-		const auto point2geometry = geometry->get_cords() - boundry_point;
-		const auto magnitude = sqrtf(point2geometry.x*point2geometry.x + point2geometry.z*point2geometry.z);
+		//movers go first, so they are the ones returned when both are hit
+		context.batch.clear();
+		gather(*mover_map, entity, cords, cords, context);
+		gather_static(entity, cords, future_pos, context);
+		gather(*obj_map, entity, cords, cords, context);
 
-		return magnitude <= geometry->get_x_radius();
+		entity::Handle result;
+		const int hit = context.batch.first_hit(probe);
+		if(hit != -1){
+			result = context.batch.get(hit)->get_handle();
+			context.stats.hits++;
+		}
+		last_query = context.stats;
+		merge_stats(last_query, 1);
+		return result;
 	}
+	//the longest step of a swept path, the bbox radius so nothing thicker than the entity's own bbox is skipped
+	inline auto sweep_step(const entity::Entity *entity) -> float {
+		return std::max(0.05f, std::min(entity->get_x_radius(), entity->get_z_radius()));
+	}
+	//normal on the ground plane at the contact of entity (at contact) with other,
+	//the face of a box or the direction from the center of a cylinder
+	inline auto contact_normal(const entity::Entity &other, const entity::Entity &entity, const glm::vec4 &contact) -> glm::vec4 {
+		const auto center = other.get_cords();
+		const float dx = contact.x - center.x;
+		const float dz = contact.z - center.z;
+		if(other.get_bbox_type() == entity::BBoxType::Rectangle){
+			const float face_x = fabsf(dx) / (other.get_x_radius() + entity.get_x_radius());
+			const float face_z = fabsf(dz) / (other.get_z_radius() + entity.get_z_radius());
+			return face_x >= face_z ?
+				glm::vec4(dx < 0 ? -1.0f : 1.0f, 0.0f, 0.0f, 0.0f) :
+				glm::vec4(0.0f, 0.0f, dz < 0 ? -1.0f : 1.0f, 0.0f);
+		}
+		const float dist = sqrtf(dx*dx + dz*dz);
+		return dist > 0.0f ? glm::vec4(dx / dist, 0.0f, dz / dist, 0.0f) : glm::vec4(0.0f);
+	}
+	auto CollisionMap::path_hit(const entity::Entity *entity, const glm::vec4 &from, const glm::vec4 &displacement, float &free_t, const QueryContext &context) const -> int {
+		const auto &batch = context.batch;
+		free_t = 1.0f;
+		const float length = sqrtf(displacement.x*displacement.x + displacement.z*displacement.z);
+		if(length == 0.0f){
+			return -1;
+		}
+		const int steps = std::max(1, static_cast<int>(ceilf(length / sweep_step(entity))));
 
-	auto CollisionMap::direction_will_collide(Entt target, Entt geometry, const glm::vec4 &dir) -> Entt {
-		const auto future_pos = target->get_cords() + (dir * target->get_speed());
-
-		if(target->get_bbox_type() == entity::BBoxType::Rectangle){
-			if(geometry->get_bbox_type() == entity::BBoxType::Rectangle){
-				return box_to_box_collision(target, geometry, future_pos) ? geometry : nullptr;
+		int hit = -1;
+		float last_free = 0.0f;
+		float hit_t = 1.0f;
+		for(int i = 1; i <= steps && hit == -1; i++){
+			const float t = i / static_cast<float>(steps);
+			hit = batch.first_hit(make_probe(*entity, from + displacement * t));
+			if(hit == -1){
+				last_free = t;
 			}else{
-				return box_to_cilinder_collision(target, geometry, future_pos) ? geometry : nullptr;
+				hit_t = t;
 			}
-		}else{ 
-			if(geometry->get_bbox_type() == entity::BBoxType::Rectangle){
-				return cilinder_to_box_collision(target, geometry, future_pos) ? geometry : nullptr;
+		}
+		if(hit == -1){
+			return -1;
+		}
+		//refines the contact between the last free sample and the first blocked one
+		for(int i = 0; i < 6; i++){
+			const float mid = (last_free + hit_t) * 0.5f;
+			const int mid_hit = batch.first_hit(make_probe(*entity, from + displacement * mid));
+			if(mid_hit == -1){
+				last_free = mid;
 			}else{
-				return cilinder_to_cilinder_collision(target, geometry, future_pos) ? geometry : nullptr;
+				hit_t = mid;
+				hit = mid_hit;
 			}
 		}
+		free_t = last_free;
+		return hit;
 	}
-	auto CollisionMap::colide_direction(Entt entity, const glm::vec4 direction) -> std::shared_ptr<entity::Entity> {
-		auto entity_map_key = mover_map.make_key(entity);
-		auto mover_neighbors = mover_map.get_quadrant(entity_map_key);
-		for(auto prox: mover_neighbors){
-			for(auto it = prox->begin(); it != prox->end();++it){
-				auto collision_target = direction_will_collide(entity, *it, direction);
-				/*
-				if(collision_target == entity){
-					std::cout << "Are you colliding with yourself swidward?" << std::endl;
-				}*/
-				if(collision_target != nullptr){
-					return collision_target;
-				}
+	auto CollisionMap::sweep(entity::Handle entity, const glm::vec4 &displacement) -> SweepResult {
+		context.stats = QueryStats();
+		const auto result = sweep(entity, displacement, context);
+		last_query = context.stats;
+		merge_stats(last_query, 1);
+		return result;
+	}
+	auto CollisionMap::sweep(entity::Handle handle, const glm::vec4 &displacement, QueryContext &context) const -> SweepResult {
+		const auto entity = registry.get(handle);
+		if(entity == nullptr){
+			return SweepResult{entity::Handle(), 1.0f, glm::vec4(0.0f), glm::vec4(0.0f)};
+		}
+		return sweep_entity(entity, displacement, context);
+	}
+	auto CollisionMap::sweep_entity(const entity::Entity *entity, const glm::vec4 &displacement, QueryContext &context) const -> SweepResult {
+		const auto start = entity->get_cords();
+		SweepResult result{entity::Handle(), 1.0f, glm::vec4(0.0f), glm::vec4(0.0f)};
+
+		//a longer move would need more steps than a sweep takes, it is cut and time tells how much is left
+		auto way = displacement;
+		const float length = sqrtf(displacement.x*displacement.x + displacement.z*displacement.z);
+		const float max_length = MAX_SWEEP_STEPS * sweep_step(entity);
+		if(length > max_length){
+			result.time = max_length / length;
+			way = displacement * result.time;
+		}
+		const auto end = start + way;
+		context.batch.clear();
+		gather(*mover_map, entity, start, end, context);
+		gather_static(entity, start, end, context);
+		gather(*obj_map, entity, start, end, context);
+
+		//what it already overlaps is left out of the path, it only takes away the part of the move into it
+		context.overlapping.clear();
+		context.batch.take_hits(make_probe(*entity, start), context.overlapping);
+		for(const auto other : context.overlapping){
+			const auto normal = contact_normal(*other, *entity, start);
+			const float into = way.x * normal.x + way.z * normal.z;
+			if(into >= 0.0f){
+				continue;
+			}
+			way -= normal * into;
+			if(result.hit.is_null()){
+				result.hit = other->get_handle();
+				result.normal = normal;
 			}
 		}
-		auto obj_map_key = obj_map.make_key(entity);
-		auto obj_neighbors = obj_map.get_quadrant(obj_map_key);
-		for(auto prox: obj_neighbors){
-			for(auto it = prox->begin(); it != prox->end();++it){
-				auto collision_target = direction_will_collide(entity, *it, direction);
-				if(collision_target != nullptr){
-					return collision_target;
-				}
+		if(!result.hit.is_null()){
+			context.stats.hits++;
+			float free_t = 1.0f;
+			if(context.batch.size() != 0 && path_hit(entity, start, way, free_t, context) != -1){
+				way *= free_t;
 			}
+			result.remainder = way;
+			result.time = 0.0f;
+			return result;
 		}
-		//std::cout << "There were:\n\tmover_calls: " << mover_calls << "\n\tobj_calls: " << obj_calls << std::endl;
-		return nullptr;
+
+		float free_t = 1.0f;
+		const int hit = context.batch.size() == 0 ? -1 : path_hit(entity, start, way, free_t, context);
+		if(hit == -1){
+			return result;
+		}
+		const auto hit_entity = context.batch.get(hit);
+		result.hit = hit_entity->get_handle();
+		result.time *= free_t;
+		context.stats.hits++;
+
+		const auto contact = start + way * free_t;
+		result.normal = contact_normal(*hit_entity, *entity, contact);
+		//slides along the contact with what is left, as far as it is free
+		const auto rest = way * (1.0f - free_t);
+		const float into = rest.x * result.normal.x + rest.z * result.normal.z;
+		auto slide = rest - result.normal * into;
+		slide.y = 0.0f;
+		slide.w = 0.0f;
+		float slide_t = 1.0f;
+		if(path_hit(entity, contact, slide, slide_t, context) != -1){
+			slide *= slide_t;
+		}
+		result.remainder = slide;
+		return result;
+	}
+	auto CollisionMap::trigger_hit(entity::Handle handle, const glm::vec4 &from) -> entity::Handle {
+		const auto entity = registry.get(handle);
+		if(entity == nullptr || !(entity->get_collision_mask() & entity::LAYER_TRIGGER)){
+			return entity::Handle();
+		}
+		const auto to = entity->get_cords();
+		context.batch.clear();
+		gather(*trigger_map, entity, from, to, context);
+		if(context.batch.size() == 0){
+			return entity::Handle();
+		}
+		float free_t;
+		int hit = path_hit(entity, from, to - from, free_t, context);
+		if(hit == -1 && from == to){
+			//did not move, path_hit has no path to walk
+			hit = context.batch.first_hit(make_probe(*entity, to));
+		}
+		return hit == -1 ? entity::Handle() : context.batch.get(hit)->get_handle();
+	}
+	auto CollisionMap::reset_stats() -> void {
+		last_query = QueryStats();
+		total_stats = QueryStats();
+		query_count = 0;
 	}
 }
\ No newline at end of file
@@ -2,7 +2,6 @@
 
 #include <utility>
 #include <unordered_map>
-#include <forward_list>
 #include <memory>
 #include <cmath>
 #include <vector>
@@ -10,6 +9,9 @@
 #include <glm/vec4.hpp>
 
 #include "../entities/entity.hpp"
+#include "../entities/registry.hpp"
+#include "narrowphase.hpp"
+#include "occupancy.hpp"
 
 namespace controler{
 	/*****************
@@ -38,59 +40,232 @@ namespace controler{
 		}
 	};
 
-	//for x y cords
-	using Entt = std::shared_ptr<entity::Entity>;
-	class SpacialHash {
+	//the cells point to the entities of the Registry, the public api of the CollisionMap takes handles
+	using Entt = entity::Entity*;
+	using GridCell = std::vector<Entt>;
+
+	//which world axes are used to make the keys, the game moves on the ground plane (x z)
+	enum class HashPlane{
+		XY,
+		XZ
+	};
+	//counters of what a colide_direction call had to look at
+	struct QueryStats{
+		long cells_visited = 0;
+		long candidates_tested = 0;
+		long hits = 0;
+	};
+	//steps of the path of a sweep, a longer displacement is cut to what they cover
+	const int MAX_SWEEP_STEPS = 256;
+	/*
+	Result of CollisionMap::sweep, the move to make is displacement * time + remainder, hit or not.
+	Something the entity already overlaps only blocks the part of the move that goes into it,
+	that is a hit at time 0 with the rest of the move in remainder.
+	*/
+	struct SweepResult{
+		entity::Handle hit;  //first thing in the way, null if the way is free
+		float time;          //fraction of the displacement done before the contact (1 if free, less if it was cut)
+		glm::vec4 normal;    //contact normal on the ground plane, zero if free
+		glm::vec4 remainder; //what is left of the displacement after sliding along the contact
+	};
+	//scratch space of a query, each thread that queries at the same time needs its own
+	struct QueryContext{
+		CandidateBatch batch;
+		std::vector<Entt> static_found;
+		std::vector<Entt> overlapping;
+		QueryStats stats;
+	};
+	enum class BroadPhaseType{
+		Hash,
+		Grid
+	};
+	//bit (i+1)*3 + (j+1) of the mask selects the neighbor cell (key.x + i, key.y + j)
+	const int QUADRANT_ALL = 0x1FF;
+	const int QUADRANT_CENTER = 1 << 4;
+
+	class BroadPhase;
+	//walks the 3x3 block of cells around a key without building a list, nothing is allocated
+	class NeighborIter {
 		public:
-			SpacialHash(float cell_x, float cell_y);
+			NeighborIter(BroadPhase *map, std::pair<int,int> key, int mask):
+				map(map), key(key), mask(mask), neighbor(0){}
+			//next non empty cell, nullptr when there are no cells left
+			auto next() -> GridCell*;
+		private:
+			BroadPhase *map;
+			std::pair<int,int> key;
+			int mask;
+			int neighbor;
+	};
+	//common interface of the broadphase backends, so the CollisionMap can pick one
+	class BroadPhase {
+		public:
+			virtual ~BroadPhase(){}
 
-			auto make_key(Entt elem) const -> std::pair<int,int>;
-			auto insert(std::pair<int,int> key, Entt elem) -> void;
-			auto remove(std::pair<int,int> key, Entt elem) -> int;
-			auto get_cell(std::pair<int,int> key) -> std::forward_list<Entt>*;
-			auto get_quadrant(std::pair<int,int> key) -> std::vector<std::forward_list<Entt>*>;
+			virtual auto make_key(const glm::vec4 &cords) const -> std::pair<int,int> = 0;
+			inline auto make_key(const entity::Entity *elem) const -> std::pair<int,int> { return make_key(elem->get_cords()); }
+			virtual auto insert(std::pair<int,int> key, Entt elem) -> void = 0;
+			virtual auto remove(std::pair<int,int> key, Entt elem) -> int = 0;
+			virtual auto get_cell(std::pair<int,int> key) -> GridCell* = 0;
 
-			auto log() const -> void;
-			auto clear() -> void;
-			//auto get_quadrant(std::pair<int,int> key, int mask) -> NeighborIter;
+			virtual auto log() const -> void = 0;
+			virtual auto clear() -> void = 0;
+
+			inline auto get_quadrant(std::pair<int,int> key, int mask = QUADRANT_ALL) -> NeighborIter {
+				return NeighborIter(this, key, mask);
+			}
+	};
+	class SpacialHash : public BroadPhase {
+		public:
+			//cell_u and cell_v are the cell sizes along the first and second axis of the plane
+			SpacialHash(float cell_u, float cell_v, HashPlane plane);
+
+			using BroadPhase::make_key;
+			auto make_key(const glm::vec4 &cords) const -> std::pair<int,int> override;
+			auto insert(std::pair<int,int> key, Entt elem) -> void override;
+			auto remove(std::pair<int,int> key, Entt elem) -> int override;
+			auto get_cell(std::pair<int,int> key) -> GridCell* override;
+
+			auto log() const -> void override;
+			auto clear() -> void override;
+
+			inline auto get_plane() const -> HashPlane { return plane; }
 		private:
 			//have it at minimum the size of the biggest enemy
-			const float cell_x, cell_y;
+			const float cell_u, cell_v;
+			const HashPlane plane;
 
 			std::unordered_map<
 				std::pair<int,int>,
-				std::forward_list<Entt>,
+				GridCell,
 				pair_hash, pair_equal_to> map;
 	};
 	/*
+	Bounded grid over the ground plane (x z), the cells are a flat array indexed by x + z * cols
+	so there is no hashing and the neighbors of a cell are right next to it in memory.
+	Anything outside the bounds is clamped to the border cells, so it still works (just slower) 
+	if something walks off the map.
+	*/
+	class DenseGrid : public BroadPhase {
+		public:
+			DenseGrid(float min_x, float min_z, float max_x, float max_z, float cell_x, float cell_z);
+
+			using BroadPhase::make_key;
+			auto make_key(const glm::vec4 &cords) const -> std::pair<int,int> override;
+			auto insert(std::pair<int,int> key, Entt elem) -> void override;
+			auto remove(std::pair<int,int> key, Entt elem) -> int override;
+			auto get_cell(std::pair<int,int> key) -> GridCell* override;
+
+			auto log() const -> void override;
+			auto clear() -> void override;
+
+			inline auto get_cols() const -> int { return cols; }
+			inline auto get_rows() const -> int { return rows; }
+		private:
+			inline auto inside(std::pair<int,int> key) const -> bool {
+				return key.first >= 0 && key.first < cols && key.second >= 0 && key.second < rows;
+			}
+			const float min_x, min_z;
+			const float cell_x, cell_z;
+			const int cols, rows;
+
+			std::vector<GridCell> cells;
+	};
+	/*
 	Has the job to handle collisions and generate paths
 		CollisionMap col;
 		if(!col.colide_foward(entity)) *does the moving stuff*;
 	*/
 	class CollisionMap{
 		public:
-			CollisionMap(float max_width, float max_depth, float mover_cell_grain, float obj_cell_grain);
+			//the entities are looked up in the registry, it must outlive the map
+			CollisionMap(const entity::Registry &registry, float max_width, float max_depth, float mover_cell_grain, float obj_cell_grain,
+				BroadPhaseType type = BroadPhaseType::Hash);
+			//stale handles are ignored and return 0
 			//for the imovable map
-			auto insert_obj(Entt obj) -> int;
-			auto remove_obj(Entt obj) -> int;
+			auto insert_obj(entity::Handle obj) -> int;
+			auto remove_obj(entity::Handle obj) -> int;
 			//for the movable map
-			auto insert_mover(Entt entity) -> int;
-			auto remove_mover(Entt entity) -> int;
+			auto insert_mover(entity::Handle entity) -> int;
+			auto remove_mover(entity::Handle entity) -> int;
+			//the houses of the map go in a occupancy grid built from the char map, instead of the obj map
+			//the walls that don't fit in it are inserted as objs
+			auto build_static(const std::vector<char> &char_map, int map_size, float tile_size,
+				const std::vector<entity::Handle> &walls) -> void;
+			//game events, they don't block and only the entities with LAYER_TRIGGER on the mask see them
+			auto insert_trigger(entity::Handle trigger) -> int;
+			auto remove_trigger(entity::Handle trigger) -> int;
+			//moves the entity between cells only if its cell changed, returns 1 if it did,
+			//0 too when it isn't in the cell of old_pos, it is not inserted then
+			auto relocate(entity::Handle entity, const glm::vec4 &old_pos, const glm::vec4 &new_pos) -> int;
 
 			auto clear() -> void;
 			//auto colide_foward(Entt entity) -> bool;
-			auto colide_direction(Entt entity, const glm::vec4 direction) -> Entt;
+			auto colide_direction(entity::Handle entity, const glm::vec4 direction) -> entity::Handle;
+			//moves the bbox along the displacement and stops at the first contact, one broadphase pass
+			//the entity should end at its position + displacement * time + remainder
+			auto sweep(entity::Handle entity, const glm::vec4 &displacement) -> SweepResult;
+			//same, but only reads the maps, can run from many threads as long as nothing is inserted,
+			//removed or moved meanwhile; the stats go in the context
+			auto sweep(entity::Handle entity, const glm::vec4 &displacement, QueryContext &context) const -> SweepResult;
+			//first trigger touched by the entity on its way from -> its current position
+			auto trigger_hit(entity::Handle entity, const glm::vec4 &from) -> entity::Handle;
+
+			//calls visit(Entt) for each mover in the cells the square of side 2 * radius touches,
+			//only reads the map like the const sweep, nothing is allocated
+			template<class Visit>
+			auto for_each_mover_near(const glm::vec4 &pos, float radius, Visit &&visit) const -> void {
+				const auto low = mover_map->make_key(glm::vec4(pos.x - radius, pos.y, pos.z - radius, 1.0f));
+				const auto high = mover_map->make_key(glm::vec4(pos.x + radius, pos.y, pos.z + radius, 1.0f));
+				for(int u = low.first; u <= high.first; u++){
+					for(int v = low.second; v <= high.second; v++){
+						const auto cell = mover_map->get_cell(std::make_pair(u, v));
+						if(cell == nullptr){
+							continue;
+						}
+						for(const auto mover : *cell){
+							visit(mover);
+						}
+					}
+				}
+			}
+			//house of the static grid over the point, nullptr if there is none
+			inline auto static_wall_at(float x, float z) const -> const entity::Entity* { return static_map.wall_at(x, z); }
+
+			//stats of the last colide_direction call and the sum since the last reset
+			inline auto get_last_query_stats() const -> const QueryStats& { return last_query; }
+			inline auto get_total_stats() const -> const QueryStats& { return total_stats; }
+			inline auto get_query_count() const -> long { return query_count; }
+			auto reset_stats() -> void;
+			//adds the stats of queries made with an outside context
+			auto merge_stats(const QueryStats &stats, long queries) -> void;
 		private:
-			auto direction_will_collide(Entt target ,Entt geometry, const glm::vec4 &dir) -> Entt;
-			auto box_to_box_collision(Entt target ,Entt geometry, const glm::vec4 future_pos) const -> bool;
-			auto cilinder_to_box_collision(Entt target ,Entt geometry, const glm::vec4 future_pos) const -> bool;
-			auto box_to_cilinder_collision(Entt target ,Entt geometry, const glm::vec4 future_pos) const -> bool;
-			auto cilinder_to_cilinder_collision(Entt target ,Entt geometry, const glm::vec4 future_pos) const -> bool;
+			//appends the cells around the path from -> to into the batch
+			//skiping the entity itself and what is not on the layers of its mask
+			auto gather(BroadPhase &map, const entity::Entity *entity, const glm::vec4 &from, const glm::vec4 &to, QueryContext &context) const -> void;
+			//appends the static walls touched by the bbox along the path from -> to
+			auto gather_static(const entity::Entity *entity, const glm::vec4 &from, const glm::vec4 &to, QueryContext &context) const -> void;
+			//first candidate of the batch hit along the path, free_t is how far it can go before it
+			auto path_hit(const entity::Entity *entity, const glm::vec4 &from, const glm::vec4 &displacement, float &free_t, const QueryContext &context) const -> int;
+			auto sweep_entity(const entity::Entity *entity, const glm::vec4 &displacement, QueryContext &context) const -> SweepResult;
+
+			auto make_broadphase(float cell_grain) const -> std::unique_ptr<BroadPhase>;
 			
+			const entity::Registry &registry;
 			const float max_width, max_depth;
 			const float mover_cell_grain, obj_cell_grain;
+			const BroadPhaseType type;
+
+			std::unique_ptr<BroadPhase> obj_map;
+			std::unique_ptr<BroadPhase> mover_map;
+			std::unique_ptr<BroadPhase> trigger_map;
+			OccupancyGrid static_map;
+
+			//reused by every query made from the game thread, so it only allocates while it grows
+			QueryContext context;
 
-			SpacialHash obj_map;
-			SpacialHash mover_map;
+			QueryStats last_query;
+			QueryStats total_stats;
+			long query_count = 0;
 	};
 }
\ No newline at end of file
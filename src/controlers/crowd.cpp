@@ -0,0 +1,91 @@
+#include "crowd.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+namespace controler{
+	//unit push for self away from other when both are on the same spot, the same pair always gets the same axis
+	//and the two get opposite ends of it
+	static auto coincident_axis(entity::Handle self, entity::Handle other) -> glm::vec4 {
+		const uint32_t low = std::min(self.index, other.index);
+		const uint32_t high = std::max(self.index, other.index);
+		const uint32_t mix = (low * 0x9E3779B1u) ^ (high * 0x85EBCA6Bu);
+		const float angle = (mix >> 8) * (2.0f * PI / 16777216.0f);
+		const float side = self.index == low ? 1.0f : -1.0f;
+		return glm::vec4(cosf(angle) * side, 0.0f, sinf(angle) * side, 0.0f);
+	}
+
+	CrowdSteering::CrowdSteering(CrowdSettings settings): settings(settings) {}
+
+	auto CrowdSteering::steer(const CollisionMap &map, const entity::Entity &self, const glm::vec4 &desired) const -> glm::vec4 {
+		const auto pos = self.get_cords();
+		const float radius = settings.neighbor_radius;
+		float separation_x = 0.0f, separation_z = 0.0f;
+		float alignment_x = 0.0f, alignment_z = 0.0f;
+		int neighbors = 0;
+
+		map.for_each_mover_near(pos, radius, [&](const entity::Entity *other){
+			if(other == &self || other->get_kind() != entity::EntityKind::Enemy){
+				return;
+			}
+			const auto other_pos = other->get_cords();
+			const float dx = pos.x - other_pos.x;
+			const float dz = pos.z - other_pos.z;
+			const float distance = sqrtf(dx*dx + dz*dz);
+			if(distance >= radius){
+				return;
+			}
+			if(distance == 0.0f){
+				//on the same spot (they spawn on the tile centers) there is no way apart, each pair gets its own
+				const auto axis = coincident_axis(self.get_handle(), other->get_handle());
+				separation_x += axis.x;
+				separation_z += axis.z;
+			}else{
+				//the closer the stronger, nothing at the edge of the radius
+				const float push = (1.0f - distance / radius) / distance;
+				separation_x += dx * push;
+				separation_z += dz * push;
+			}
+			const auto other_dir = other->get_direction();
+			alignment_x += other_dir.x;
+			alignment_z += other_dir.z;
+			neighbors++;
+		});
+
+		float heading_x = desired.x;
+		float heading_z = desired.z;
+		if(neighbors > 0){
+			heading_x += separation_x * settings.separation_weight + (alignment_x / neighbors) * settings.alignment_weight;
+			heading_z += separation_z * settings.separation_weight + (alignment_z / neighbors) * settings.alignment_weight;
+		}
+
+		//a house ahead pushes to the side it is less in the way
+		const float ahead_x = pos.x + desired.x * settings.avoidance_distance;
+		const float ahead_z = pos.z + desired.z * settings.avoidance_distance;
+		const auto wall = map.static_wall_at(ahead_x, ahead_z);
+		if(wall != nullptr){
+			const auto wall_pos = wall->get_cords();
+			const float away_x = ahead_x - wall_pos.x;
+			const float away_z = ahead_z - wall_pos.z;
+			//the part across the way, straight ahead into the center goes to the left
+			const float along = away_x * desired.x + away_z * desired.z;
+			float side_x = away_x - desired.x * along;
+			float side_z = away_z - desired.z * along;
+			float side = sqrtf(side_x*side_x + side_z*side_z);
+			if(side < 1e-4f){
+				side_x = -desired.z;
+				side_z = desired.x;
+				side = 1.0f;
+			}
+			heading_x += side_x / side * settings.avoidance_weight;
+			heading_z += side_z / side * settings.avoidance_weight;
+		}
+
+		const float length = sqrtf(heading_x*heading_x + heading_z*heading_z);
+		if(length < 1e-4f){
+			return desired;
+		}
+		return glm::vec4(heading_x / length, 0.0f, heading_z / length, 0.0f);
+	}
+}
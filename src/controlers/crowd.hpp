@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glm/vec4.hpp>
+
+#include "../entities/entity.hpp"
+#include "collision.hpp"
+
+namespace controler{
+	struct CrowdSettings{
+		float neighbor_radius;    //how far around a zombie the others are seen
+		float separation_weight;  //push away from the zombies too close
+		float alignment_weight;   //turn to the way the zombies around are going
+		float avoidance_distance; //how far ahead a zombie looks for houses
+		float avoidance_weight;   //push to the side when a house is ahead
+	};
+	/*
+	Local steering of the horde on top of the way the flow field gives, so a group spreads out and goes
+	around the houses before the sweep has to stop it against them.
+	The neighbors come from the mover grid of the CollisionMap and the houses from its static grid.
+	Only reads, so many zombies can be steered at once as long as nothing moves meanwhile.
+		CrowdSteering crowd(settings);
+		const auto heading = crowd.steer(collision_map, *enemy, desired);
+	*/
+	class CrowdSteering{
+		public:
+			CrowdSteering(CrowdSettings settings);
+
+			//unit heading on the ground plane for an entity that wants to go along desired (unit)
+			auto steer(const CollisionMap &map, const entity::Entity &self, const glm::vec4 &desired) const -> glm::vec4;
+
+			inline auto get_settings() const -> const CrowdSettings& { return settings; }
+			inline auto set_settings(CrowdSettings s) -> void { settings = s; }
+		private:
+			CrowdSettings settings;
+	};
+}
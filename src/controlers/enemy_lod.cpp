@@ -0,0 +1,102 @@
+#include "enemy_lod.hpp"
+
+#include <algorithm>
+
+namespace controler{
+	EnemyLod::EnemyLod(LodSettings settings): settings(settings) {}
+
+	auto EnemyLod::begin_tick() -> void {
+		tick++;
+		budget = settings.full_budget;
+		full_updates = 0;
+		deferred = 0;
+	}
+
+	auto EnemyLod::tier_of(float distance) const -> LodTier {
+		if(distance > settings.far_distance){
+			return LodTier::Far;
+		}
+		return distance > settings.mid_distance ? LodTier::Mid : LodTier::Near;
+	}
+
+	auto EnemyLod::state_of(entity::Handle enemy) -> State& {
+		if(enemy.index >= states.size()){
+			states.resize(enemy.index + 1);
+		}
+		auto &state = states[enemy.index];
+		if(state.generation != enemy.generation){
+			state = State();
+			state.generation = enemy.generation;
+			state.last_full = tick - 1;
+			state.next_full = tick;
+		}
+		return state;
+	}
+
+	auto EnemyLod::plan(entity::Handle enemy, float distance) -> LodPlan {
+		auto &state = state_of(enemy);
+		const auto tier = tier_of(distance);
+		//coming closer it can't wait for the timer of the farther tier
+		if(tier < state.tier){
+			state.next_full = tick;
+		}
+		state.tier = tier;
+
+		if(tier == LodTier::Near){
+			state.drift_ticks = 0;
+			state.last_full = tick;
+			full_updates++;
+			return LodPlan{true, 1, 1.0f};
+		}
+		if(tick < state.next_full){
+			return LodPlan{false, 0, 0.0f};
+		}
+		if(budget <= 0){
+			deferred++;
+			return LodPlan{false, 0, 0.0f};
+		}
+		budget--;
+		full_updates++;
+		LodPlan result;
+		result.full = true;
+		if(tier == LodTier::Mid){
+			//sweeps the moves of the whole interval ahead, they are spread over it
+			result.ticks = std::max(settings.mid_interval, 1);
+			result.share = 1.0f / result.ticks;
+			state.next_full = tick + result.ticks;
+		}else{
+			//catches up the ticks it stood still, capped so a long wait doesn't make it jump across the map
+			result.ticks = static_cast<int>(std::min<long>(tick - state.last_full, 2L * std::max(settings.far_interval, 1)));
+			result.share = 1.0f;
+			state.next_full = tick + std::max(settings.far_interval, 1);
+		}
+		state.drift_ticks = 0;
+		state.last_full = tick;
+		return result;
+	}
+
+	auto EnemyLod::set_drift(entity::Handle enemy, const glm::vec4 &step, int ticks) -> void {
+		auto &state = state_of(enemy);
+		state.step = step;
+		state.drift_ticks = ticks;
+	}
+
+	auto EnemyLod::drift(entity::Handle enemy) -> glm::vec4 {
+		auto &state = state_of(enemy);
+		if(state.drift_ticks <= 0){
+			return glm::vec4(0.0f);
+		}
+		state.drift_ticks--;
+		return state.step;
+	}
+
+	auto EnemyLod::reset(entity::Handle enemy) -> void {
+		if(enemy.index < states.size()){
+			states[enemy.index].generation = 0;
+		}
+	}
+
+	auto EnemyLod::clear() -> void {
+		states.clear();
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/vec4.hpp>
+
+#include "../entities/handle.hpp"
+
+namespace controler{
+	//how close to the player an enemy is, the farther the less often it gets a full update
+	enum class LodTier : unsigned char {
+		Near, //full update every tick
+		Mid,  //full update every mid_interval ticks, drifts along the last swept move in between
+		Far   //full update every far_interval ticks, covering all the ticks since the last one at once
+	};
+	struct LodSettings{
+		float mid_distance;      //from the player, past it an enemy is Mid
+		float far_distance;      //past it an enemy is Far
+		int mid_interval;        //ticks between the full updates of a Mid enemy
+		int far_interval;        //ticks between the full updates of a Far enemy
+		int full_budget;         //full updates of Mid and Far enemies per tick, the Near ones always get theirs
+	};
+	//what an enemy does in a tick
+	struct LodPlan{
+		bool full;   //retargets and sweeps this tick
+		int ticks;   //ticks of movement the sweep covers
+		float share; //part of the swept move applied now, the rest is the drift of the next ticks
+	};
+	/*
+	Decides which enemies get the full update (retarget and collision sweep) in a tick.
+	Most of the horde is far from the player, it can move in coarse steps without anyone noticing.
+		lod.begin_tick();
+		const auto plan = lod.plan(handle, distance);
+		if(plan.full){ sweep plan.ticks of movement, apply plan.share of it, lod.set_drift(...) }
+		else{ enemy->translate(lod.drift(handle)); }
+	The state is kept by the slot of the handle, call reset when an enemy is (re)placed.
+	*/
+	class EnemyLod{
+		public:
+			EnemyLod(LodSettings settings);
+
+			auto begin_tick() -> void;
+			auto plan(entity::Handle enemy, float distance) -> LodPlan;
+			//the step of the enemy for each of the next ticks it doesn't get a full update
+			auto set_drift(entity::Handle enemy, const glm::vec4 &step, int ticks) -> void;
+			//the step for this tick, zero if it has none left
+			auto drift(entity::Handle enemy) -> glm::vec4;
+			//the enemy gets a full update on its next plan
+			auto reset(entity::Handle enemy) -> void;
+			auto clear() -> void;
+
+			auto tier_of(float distance) const -> LodTier;
+			inline auto get_settings() const -> const LodSettings& { return settings; }
+			inline auto set_settings(LodSettings s) -> void { settings = s; }
+			//full updates given in the last tick, the Near ones included
+			inline auto get_full_updates() const -> int { return full_updates; }
+			//enemies due for a full update that waited for the budget in the last tick
+			inline auto get_deferred() const -> int { return deferred; }
+		private:
+			struct State{
+				uint32_t generation = 0; //of the handle it belongs to, a mismatch means a new enemy
+				LodTier tier = LodTier::Near;
+				long last_full = 0;
+				long next_full = 0;
+				glm::vec4 step = glm::vec4(0.0f);
+				int drift_ticks = 0;
+			};
+			auto state_of(entity::Handle enemy) -> State&;
+
+			LodSettings settings;
+			std::vector<State> states; //by index of the handle
+			long tick = 0;
+			int budget = 0;
+			int full_updates = 0;
+			int deferred = 0;
+	};
+}
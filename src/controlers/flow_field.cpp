@@ -0,0 +1,221 @@
+#include "flow_field.hpp"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace controler{
+	const int FlowField::UNREACHABLE = std::numeric_limits<int>::max();
+
+	//the 8 neighbors, diagonals cost ~sqrt(2) of a side
+	static const int NEIGHBOR_X[8]    = { 1, -1,  0,  0,  1,  1, -1, -1};
+	static const int NEIGHBOR_Z[8]    = { 0,  0,  1, -1,  1, -1,  1, -1};
+	static const int NEIGHBOR_COST[8] = {10, 10, 10, 10, 14, 14, 14, 14};
+	//one more than the most expensive step
+	static const int BUCKET_COUNT = 15;
+
+	FlowField::FlowField(){}
+
+	auto FlowField::build(const std::vector<char> &char_map, int map_size, float _tile_size) -> void {
+		size = map_size;
+		tile_size = _tile_size;
+		const int tiles = size * size;
+		blocked.assign(tiles, 0);
+		for(int i = 0; i < tiles; i++){
+			blocked[i] = char_map[i] == '#';
+		}
+		cost.assign(tiles, UNREACHABLE);
+		marked.assign(tiles, 0);
+		buckets.assign(BUCKET_COUNT, std::vector<int>());
+		dir_x.assign(tiles, 0.0f);
+		dir_z.assign(tiles, 0.0f);
+		target_tile = -1;
+	}
+
+	auto FlowField::clear() -> void {
+		size = 0;
+		blocked.clear();
+		cost.clear();
+		marked.clear();
+		marked_tiles.clear();
+		buckets.clear();
+		dir_x.clear();
+		dir_z.clear();
+		target_tile = -1;
+	}
+
+	auto FlowField::tile_of(float x, float z) const -> int {
+		//the tiles are centered at i * 2 * tile_size + tile_size / 2, like the Generator places them
+		const float span = 2.0f * tile_size;
+		const int tx = std::min(std::max(static_cast<int>(floorf((x + tile_size / 2) / span)), 0), size - 1);
+		const int tz = std::min(std::max(static_cast<int>(floorf((z + tile_size / 2) / span)), 0), size - 1);
+		return tx + tz * size;
+	}
+
+	auto FlowField::update(const glm::vec4 &target) -> bool {
+		if(empty()){
+			return false;
+		}
+		target_x = target.x;
+		target_z = target.z;
+		const int tile = tile_of(target.x, target.z);
+		if(tile == target_tile){
+			return false;
+		}
+		const int old_target = target_tile;
+		target_tile = tile;
+		if(!incremental || old_target == -1 || !repair(old_target)){
+			compute();
+		}
+		return true;
+	}
+
+	auto FlowField::direction(float x, float z) const -> glm::vec4 {
+		if(!empty()){
+			const int tile = tile_of(x, z);
+			if(dir_x[tile] != 0.0f || dir_z[tile] != 0.0f){
+				return glm::vec4(dir_x[tile], 0.0f, dir_z[tile], 0.0f);
+			}
+		}
+		const float dx = target_x - x;
+		const float dz = target_z - z;
+		const float length = sqrtf(dx*dx + dz*dz);
+		if(length == 0.0f){
+			return glm::vec4(0.0f);
+		}
+		return glm::vec4(dx / length, 0.0f, dz / length, 0.0f);
+	}
+
+	//neighbor n of the tile, -1 if it is outside the map or a diagonal that cuts the corner of a house
+	auto FlowField::neighbor(int tile, int n) const -> int {
+		const int x = tile % size + NEIGHBOR_X[n];
+		const int z = tile / size + NEIGHBOR_Z[n];
+		if(x < 0 || x >= size || z < 0 || z >= size){
+			return -1;
+		}
+		if(n >= 4 && (blocked[x + (tile / size) * size] || blocked[(tile % size) + z * size])){
+			return -1;
+		}
+		return x + z * size;
+	}
+
+	auto FlowField::compute() -> void {
+		rebuilds++;
+		base = 0;
+		std::fill(cost.begin(), cost.end(), UNREACHABLE);
+		cost[target_tile] = 0;
+		propagate();
+		last_touched = static_cast<int>(changed.size());
+
+		const int tiles = size * size;
+		for(int tile = 0; tile < tiles; tile++){
+			update_direction(tile);
+		}
+	}
+
+	/*
+	Dijkstra from the target over the tiles that are not blocked, only going where it lowers the cost.
+	The steps cost 10 or 14, so the tiles waiting are never more than 14 apart in cost and a ring of
+	15 buckets by cost does the work of the heap, pushing and taking a tile is O(1).
+	*/
+	auto FlowField::propagate() -> void {
+		changed.clear();
+		buckets[0].push_back(target_tile);
+		int pending = 1;
+		for(int key = base; pending > 0; key++){
+			auto &bucket = buckets[(key - base) % BUCKET_COUNT];
+			while(!bucket.empty()){
+				const int tile = bucket.back();
+				bucket.pop_back();
+				pending--;
+				//it got cheaper after it was put here, the cheaper entry was taken already
+				if(cost[tile] != key){
+					continue;
+				}
+				changed.push_back(tile);
+				for(int n = 0; n < 8; n++){
+					const int next = neighbor(tile, n);
+					if(next == -1 || blocked[next]){
+						continue;
+					}
+					const int next_cost = key + NEIGHBOR_COST[n];
+					if(next_cost < cost[next]){
+						cost[next] = next_cost;
+						buckets[(next_cost - base) % BUCKET_COUNT].push_back(next);
+						pending++;
+					}
+				}
+			}
+		}
+	}
+
+	/*
+	Moving the target from A to B, every path that went to A can go on to B, so the new cost of a tile
+	is never more than its old one plus the cost from A to B. Taking that much out of the base,
+	the tiles whose path goes through A keep the cost they have and the others only get cheaper.
+	So the repair is a dijkstra from B that stops at the tiles it doesn't make cheaper,
+	it visits the part of the map that is now closer to B than by going through A.
+	It only holds if A is a tile that can be walked through, so a target in a house is computed whole.
+	*/
+	auto FlowField::repair(int old_target) -> bool {
+		if(blocked[old_target] || blocked[target_tile] || cost[target_tile] == UNREACHABLE){
+			return false;
+		}
+		const int distance = cost[target_tile] - base;
+		//far from overflowing, the next compute starts it from 0 again
+		if(base - distance < std::numeric_limits<int>::min() / 2){
+			return false;
+		}
+		rebuilds++;
+		base -= distance;
+		cost[target_tile] = base;
+		propagate();
+		last_touched = static_cast<int>(changed.size());
+
+		//only the directions next to a changed cost can change, and the old target has none yet
+		changed.push_back(old_target);
+		marked_tiles.clear();
+		for(const int tile : changed){
+			const int x = tile % size;
+			const int z = tile / size;
+			for(int mz = std::max(z - 1, 0); mz <= std::min(z + 1, size - 1); mz++){
+				for(int mx = std::max(x - 1, 0); mx <= std::min(x + 1, size - 1); mx++){
+					const int around = mx + mz * size;
+					if(!marked[around]){
+						marked[around] = 1;
+						marked_tiles.push_back(around);
+					}
+				}
+			}
+		}
+		//only the marked ones, a pass over the whole map would cost as much as the compute
+		for(const int tile : marked_tiles){
+			marked[tile] = 0;
+			update_direction(tile);
+		}
+		return true;
+	}
+
+	//each tile to its cheapest neighbor, the houses too so whoever is in one walks out
+	auto FlowField::update_direction(int tile) -> void {
+		dir_x[tile] = 0.0f;
+		dir_z[tile] = 0.0f;
+		if(tile == target_tile){
+			return;
+		}
+		int best = blocked[tile] ? UNREACHABLE : cost[tile];
+		int best_n = -1;
+		for(int n = 0; n < 8; n++){
+			const int next = neighbor(tile, n);
+			if(next != -1 && cost[next] < best){
+				best = cost[next];
+				best_n = n;
+			}
+		}
+		if(best_n != -1){
+			const float length = best_n < 4 ? 1.0f : sqrtf(2.0f);
+			dir_x[tile] = NEIGHBOR_X[best_n] / length;
+			dir_z[tile] = NEIGHBOR_Z[best_n] / length;
+		}
+	}
+}
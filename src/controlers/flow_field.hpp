@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+namespace controler{
+	/*
+	Paths from every tile of the map to the tile of the player, shared by the whole horde.
+	The integration field is the cost of walking from each tile to the target tile (the houses block),
+	the direction field points each tile to its neighbor with the lowest cost.
+	It is only computed again when the player changes tile, so the cost doesn't grow with the zombies.
+	After the first computation the fields are repaired instead of rebuilt, only the tiles whose cost changed
+	with the new target are visited (see repair).
+		FlowField field;
+		field.build(char_map, map_size, tile_size);
+		field.update(player->get_cords());
+		enemy->face(field.direction(pos.x, pos.z));
+	*/
+	class FlowField{
+		public:
+			FlowField();
+
+			//'#' tiles are blocked, the rest can be walked on
+			auto build(const std::vector<char> &char_map, int map_size, float tile_size) -> void;
+			auto clear() -> void;
+			//computes the fields again if the target is in another tile, returns if it did
+			auto update(const glm::vec4 &target) -> bool;
+
+			/*
+			Unit direction to follow from the point. In the tile of the target, or where it can't be reached,
+			it points straight to the target. Zero when the point is on top of the target.
+			*/
+			auto direction(float x, float z) const -> glm::vec4;
+			//tile of a point of the world, points outside the map go to the nearest tile
+			auto tile_of(float x, float z) const -> int;
+
+			inline auto empty() const -> bool { return size == 0; }
+			inline auto get_target_tile() const -> int { return target_tile; }
+			//walking cost from the tile to the target, UNREACHABLE if there is no path
+			inline auto get_cost(int tile) const -> int { return cost[tile] == UNREACHABLE ? UNREACHABLE : cost[tile] - base; }
+			//times the fields were computed, for the stats
+			inline auto get_rebuilds() const -> long { return rebuilds; }
+			//tiles whose cost was set in the last update
+			inline auto get_last_touched() const -> int { return last_touched; }
+			//false rebuilds the whole fields on every target change, to compare
+			inline auto set_incremental(bool value) -> void { incremental = value; }
+
+			static const int UNREACHABLE;
+		private:
+			//both fields from scratch
+			auto compute() -> void;
+			//lowers the costs from the target outwards, the tiles it set end up in changed
+			auto propagate() -> void;
+			//moves the target and fixes only the costs that changed, false if it can't and the fields must be computed
+			auto repair(int old_target) -> bool;
+			auto update_direction(int tile) -> void;
+			auto neighbor(int tile, int n) const -> int;
+
+			int size = 0;
+			float tile_size = 1.0f;
+			std::vector<unsigned char> blocked;
+			std::vector<int> cost;            //integration field, plus base
+			int base = 0;                     //cost of the target tile
+			std::vector<std::vector<int>> buckets; //tiles waiting in the dijkstra, by cost
+			std::vector<int> changed;
+			std::vector<unsigned char> marked;
+			std::vector<int> marked_tiles; //the tiles set in marked, so they are found without a pass over the map
+			std::vector<float> dir_x, dir_z;  //direction field, zero where it points straight to the target
+			int target_tile = -1;
+			float target_x = 0.0f, target_z = 0.0f;
+			long rebuilds = 0;
+			int last_touched = 0;
+			bool incremental = true;
+	};
+}
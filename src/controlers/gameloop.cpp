@@ -1,19 +1,8 @@
 #include "gameloop.hpp"
-namespace controler{
-	inline auto outside_map(std::shared_ptr<entity::Player> player, const glm::vec4 dir, const float map_size, const float tile_size) -> bool{
-		const auto pos = player->get_cords() + dir;
-		const float bx = player->get_x_radius();
-		const float bz = player->get_z_radius();
-		const float max_border = map_size * (2 * tile_size) - (tile_size / 2) ;
-		const float min_border = -(tile_size / 2);
-
-		return (pos.x < min_border + bx) || (pos.x > max_border - bx) || (pos.z < min_border + bz) || (pos.z > max_border - bz);
-	}
 
+namespace controler{
 	GameLoop::GameLoop(std::unique_ptr<entity::Camera> _camera,
-		std::unique_ptr<CollisionMap> _collision_map,
-		std::unique_ptr<Generator> _generator,
-		std::shared_ptr<entity::Player> _player,
+		std::unique_ptr<Simulation> _simulation,
 		std::shared_ptr<render::GPUprogram> phong_phong,
 		std::shared_ptr<render::GPUprogram> phong_diffuse,
 		std::shared_ptr<render::GPUprogram> gouraud_phong,
@@ -26,8 +15,7 @@ namespace controler{
 		CursorState *cursor,
 		float *screen_ratio, bool *paused,
 		GLFWwindow *window):
-		camera(std::move(_camera)), collision_map(std::move(_collision_map)), generator(std::move(_generator)),
-		player(_player),
+		camera(std::move(_camera)), simulation(std::move(_simulation)),
 		phong_phong(phong_phong), phong_diffuse(phong_diffuse),
 		gouraud_phong(gouraud_phong), gouraud_diffuse(gouraud_diffuse),
 		wire_renderer(wire_renderer), menu_renderer(menu_renderer),
@@ -36,14 +24,30 @@ namespace controler{
 		screen_ratio(screen_ratio), paused(paused),
 		window(window)
 	{
-		collision_map->insert_mover(player);
+		input.reset(new LiveInput(pressed_keys, camera.get()));
 	} 
 
 
 	GameLoop::~GameLoop(){}
-	auto GameLoop::update(float delta_time) -> void {
-		time += delta_time;
+	auto GameLoop::record_input(const std::string &path) -> void {
+		input.reset(new InputRecorder(std::move(input), path, simulation->get_seed(), 1.0f / sim_clock.get_step()));
+		//a time budget would think a different number of zombies on the replay
+		simulation->set_ai_settings(AiSettings::replayable());
+	}
+	auto GameLoop::replay_input(const std::string &path) -> void {
+		std::unique_ptr<InputReplayer> replay(new InputReplayer(path));
+		simulation->set_seed(replay->get_seed());
+		simulation->set_ai_settings(AiSettings::replayable());
+		sim_clock.set_tick_rate(replay->get_tick_rate());
+		input = std::move(replay);
+	}
+	auto GameLoop::update(float frame_seconds) -> void {
+		const float delta_time = frame_seconds * GAME_TIME_UNITS_PER_SECOND;
 		cursor_delay += delta_time;
+		if(state != GameState::Playing){
+			//while playing the time only goes forward with the ticks
+			time += delta_time;
+		}
 		switch (state){
 		case GameState::MainMenu :
 			/* render the menu screen */
@@ -62,7 +66,7 @@ namespace controler{
 			update_screen(GameState::Credits);
 			break;
 		case GameState::Playing :
-			update_playing(delta_time);
+			update_playing(frame_seconds);
 			break;
 		default:
 			std::cout << "oops" << std::endl;
@@ -71,33 +75,16 @@ namespace controler{
 	}
 
 	auto GameLoop::setup_playing_state() -> void {
-		auto map_elements = generator->generate_map_elements(2);
-
-		for(const auto &tile : map_elements.tiles){
-			insert_background(tile);
-		}
-		for(const auto &wall : map_elements.walls){
-			insert_wall(wall);
-		}
-		for(const auto &ge : map_elements.game_events){
-			insert_game_event(ge);
-		}
-		const auto valid_position = generator->get_vacant_position();
-		collision_map->remove_mover(player);
-		player->set_cords(valid_position.x, valid_position.y, valid_position.z);
-		collision_map->insert_mover(player);
+		simulation->start_round();
+		sim_clock.reset();
 		time = 0;
 	}
 	auto GameLoop::clear_playing_state() -> void {
-		score = 0;
 		time = 0;
-		enemies.clear();
-		game_events.clear();
-		walls.clear();
-		background.clear();
-		collision_map->clear();
+		simulation->clear_round();
 	}
 
+
 	auto GameLoop::update_screen(GameState type) -> void {
 		entity::LookAtParameters menu_view{0,0,1.5};
 		camera->update_position(menu_view, glm::vec4(0.0f,0.0f,0.0f,1.0f));
@@ -110,77 +97,79 @@ namespace controler{
 		const auto screen = screens.at(type);
 		screen->draw(screen->get_transform());
 		screen->draw_nodes(time);
+		auto action = entity::MenuOptions::None;
 		if(cursor->clicked && (cursor_delay > 25)){
 			cursor_delay = 0;
 			//std::cout << "x: " << cursor->x << " y: " << cursor->y << std::endl;
-			const auto action = screen->click_action(cursor->x,cursor->y,800,800);
-			switch (action){
-			case entity::MenuOptions::Play:
-				//std::cout << "Play" << std::endl;
-				state = GameState::Playing;
-				glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-				clear_playing_state();
-				setup_playing_state();
-				break;
-			case entity::MenuOptions::Exit:
-				//std::cout << "Exit" << std::endl;
-				exit(0);
-				break;
-			case entity::MenuOptions::Retry:
-				//std::cout << "Retry" << std::endl;
-				state = GameState::Playing;
-				glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-				clear_playing_state();
-				setup_playing_state();
-				break;
-			case entity::MenuOptions::Credits:
-				//std::cout << "Credits" << std::endl;
-				state = GameState::Credits;
-				glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-				break;
-			case entity::MenuOptions::ToMenu:
-				//std::cout << "ToMenu" << std::endl;
-				state = GameState::MainMenu;
-				glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-				break;
-			case entity::MenuOptions::RickRoll:
+			action = screen->click_action(cursor->x,cursor->y,800,800);
+		}
+		//the clicks that start and end rounds go through the input, so a recording has them and a replay plays them
+		auto clicked = RoundEvent::None;
+		if(action == entity::MenuOptions::Play || action == entity::MenuOptions::Retry){
+			clicked = RoundEvent::Start;
+		}else if(action == entity::MenuOptions::Exit || action == entity::MenuOptions::RickRoll){
+			clicked = RoundEvent::Exit;
+		}
+		const auto event = input->round_event(clicked);
+		if(event == RoundEvent::Start){
+			state = GameState::Playing;
+			glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+			clear_playing_state();
+			setup_playing_state();
+			return;
+		}
+		if(event == RoundEvent::Exit){
+			if(action == entity::MenuOptions::RickRoll){
 				std::cout << "https://youtu.be/dQw4w9WgXcQ" << std::endl;
-				exit(0);
-				break;
-			default:
-				//std::cout << "None" << std::endl;
-				break;
 			}
+			//ends the render loop, the input goes out with the GameLoop and a recording gets closed
+			glfwSetWindowShouldClose(window, GL_TRUE);
+			return;
+		}
+		switch (action){
+		case entity::MenuOptions::Credits:
+			//std::cout << "Credits" << std::endl;
+			state = GameState::Credits;
+			glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+			break;
+		case entity::MenuOptions::ToMenu:
+			//std::cout << "ToMenu" << std::endl;
+			state = GameState::MainMenu;
+			glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+			break;
+		default:
+			//std::cout << "None" << std::endl;
+			break;
 		}
 	}
-	auto GameLoop::update_playing(float delta_time) -> void {
+	auto GameLoop::update_playing(float frame_seconds) -> void {
+		float alpha = 1.0f;
 		if(*paused){
-			update_camera_free(delta_time);
+			update_camera_free(frame_seconds * GAME_TIME_UNITS_PER_SECOND);
+			//the time spent paused is not simulated after
+			sim_clock.reset();
 		}
 		else {
-			if(static_cast<int>(time) % spawn_rate == 0){
-				//std::cout << "spawn enemy" << std::endl;
-				auto new_enemy = generator->generate_enemy(static_cast<int>(MeshIds::ENEMY));
-				insert_enemy(new_enemy);
+			//the simulation runs in fixed steps whatever the frame rate is, the render interpolates between them
+			const int ticks = sim_clock.advance(frame_seconds);
+			const float tick_delta = sim_clock.get_step() * GAME_TIME_UNITS_PER_SECOND;
+			for(int i = 0; i < ticks && state == GameState::Playing; i++){
+				tick(tick_delta);
 			}
-			update_camera_look_at();
-			const auto event_player = update_player(delta_time,*pressed_keys);
-			handle_event(event_player.first, event_player.second);
-			const auto event_enemies = update_enemies(delta_time);
-			handle_event(event_enemies,nullptr);
+			alpha = sim_clock.get_alpha();
+			update_camera_look_at(alpha);
 		}
-		render_frame();
+		render_frame(alpha);
 		if(draw_bbox){
-			render_bbox(); 
+			render_bbox(alpha); 
 		}
 	}
+	auto GameLoop::tick(float delta_time) -> void {
+		handle_event(simulation->tick(delta_time, input->next()));
+	}
 
-	auto GameLoop::handle_event(entity::GameEventTypes game_event_type, std::shared_ptr<entity::GameEvent> game_event) -> void {
+	auto GameLoop::handle_event(entity::GameEventTypes game_event_type) -> void {
 		switch (game_event_type){
-		case entity::GameEventTypes::Point :
-			remove_game_event(game_event);
-			//std::cout << ++score << std::endl;
-			break;
 		case entity::GameEventTypes::EndPoint :
 			state = GameState::GameWin;
 			glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
@@ -193,51 +182,11 @@ namespace controler{
 			break;
 		}
 	}
-	auto GameLoop::is_game_event_event(entity::GameEventTypes game_event_type) -> bool {
-		switch (game_event_type) {
-		case entity::GameEventTypes::Point:
-			return true;
-			break;
-		case entity::GameEventTypes::EndPoint:
-			return true;
-			break;
-		default:
-			return false;
-			break;
-		}
-	}
-	auto GameLoop::insert_enemy(std::shared_ptr<entity::Enemy> enemy) -> void {
-		enemies.insert(enemy);
-		collision_map->insert_mover(enemy);
-	}
-	auto GameLoop::insert_wall(std::shared_ptr<entity::Wall> wall) -> void {
-		walls.insert(wall);
-		collision_map->insert_obj(wall);
-	}
-	auto GameLoop::insert_game_event(std::shared_ptr<entity::GameEvent> game_event) -> void {
-		game_events.insert(game_event);
-		collision_map->insert_mover(game_event);
-	}
-	auto GameLoop::insert_background(std::shared_ptr<entity::Entity> bg) -> void {
-		background.insert(bg);
-	}
-	auto GameLoop::remove_enemy(std::shared_ptr<entity::Enemy> enemy) -> void {
-		enemies.erase(enemy);
-		collision_map->remove_mover(enemy);
-	}
-	auto GameLoop::remove_wall(std::shared_ptr<entity::Wall> wall) -> void {
-		walls.erase(wall);
-		collision_map->remove_obj(wall);
-	}
-	auto GameLoop::remove_game_event(std::shared_ptr<entity::GameEvent> game_event) -> void {
-		game_events.erase(game_event);
-		collision_map->remove_mover(game_event);
-	}
-	auto GameLoop::remove_background(std::shared_ptr<entity::Entity> bg) -> void {
-		background.erase(bg);
-	}
 
-	auto GameLoop::render_frame() -> void {
+
+	auto GameLoop::render_frame(float alpha) -> void {
+		const auto &registry = simulation->get_registry();
+		const auto player = simulation->get_player();
 		glm::vec4 cords = player->get_cords();
 		glm::vec4 c_dir = camera->get_direction();  
 		phong_phong->use_prog();
@@ -246,12 +195,14 @@ namespace controler{
 		phong_phong->set_4floats("player_pos",cords.x, cords.y, cords.z, cords.w);
 		phong_phong->set_bool("paused", *paused);
 		phong_phong->set_4floats("camera_dir", c_dir.x, c_dir.y, c_dir.z, c_dir.w);
-		const auto p_trans = player->get_transform();
-		player->draw(p_trans);
-		for(auto enemy: enemies){
-			enemy->draw(enemy->get_transform());
+		//the movers are drawn between their last two ticks, the rest doesn't move
+		player->draw(player->get_interpolated_transform(alpha));
+		for(const auto handle : simulation->get_enemies()){
+			const auto enemy = registry.get(handle);
+			enemy->draw(enemy->get_interpolated_transform(alpha));
 		}
-		for(auto wall: walls){
+		for(const auto handle : simulation->get_walls()){
+			const auto wall = registry.get(handle);
 			wall->draw(wall->get_transform());
 		}
 		phong_diffuse->use_prog();
@@ -260,7 +211,8 @@ namespace controler{
 		phong_diffuse->set_4floats("player_pos",cords.x, cords.y, cords.z, cords.w);
 		phong_diffuse->set_bool("paused", *paused);
 		phong_diffuse->set_4floats("camera_dir", c_dir.x, c_dir.y, c_dir.z, c_dir.w);
-		for(auto bg : background){
+		for(const auto handle : simulation->get_background()){
+			const auto bg = registry.get(handle);
 			bg->draw(bg->get_transform());
 		}
 		gouraud_phong->use_prog();
@@ -269,119 +221,39 @@ namespace controler{
 		gouraud_phong->set_4floats("player_pos",cords.x, cords.y, cords.z, cords.w);
 		gouraud_phong->set_bool("paused", *paused);
 		gouraud_phong->set_4floats("camera_dir", c_dir.x, c_dir.y, c_dir.z, c_dir.w);
-		for(auto game_event : game_events){
+		for(const auto handle : simulation->get_game_events()){
+			const auto game_event = registry.get(handle);
 			game_event->draw(game_event->get_transform());
 		}
 	} 
 
-	auto GameLoop::render_bbox() -> void {
+	auto GameLoop::render_bbox(float alpha) -> void {
 		wire_renderer->use_prog();
 		wire_renderer->set_mtx("view",camera->get_view_ptr());
 		wire_renderer->set_mtx("projection",camera->get_projection_ptr());
 
+		const auto &registry = simulation->get_registry();
+		const auto player = simulation->get_player();
 		//TODO: mudar o resto
-		const auto pt = player->get_translation() * player->get_bbox_scale();
-		player->draw_wire(pt);
-		for(auto enemy: enemies){
-			const auto et = enemy->get_translation() * enemy->get_bbox_scale();
-			enemy->draw_wire(et);
+		player->draw_wire(player->get_interpolated_bbox_transform(alpha));
+		for(const auto handle : simulation->get_enemies()){
+			const auto enemy = registry.get(handle);
+			enemy->draw_wire(enemy->get_interpolated_bbox_transform(alpha));
 		}
-		for(auto wall: walls){
-			const auto wt = wall->get_translation() * wall->get_bbox_scale();
+		for(const auto handle : simulation->get_walls()){
+			const auto wall = registry.get(handle);
+			const auto &wt = wall->get_bbox_transform();
 			wall->draw_wire(wt);
 		}
-		for(auto game_event : game_events){
-			const auto gt = game_event->get_translation() * game_event->get_bbox_scale();
+		for(const auto handle : simulation->get_game_events()){
+			const auto game_event = registry.get(handle);
+			const auto &gt = game_event->get_bbox_transform();
 			game_event->draw_wire(gt);
 		}
 	}
 
-	auto GameLoop::update_player(float delta_time, entity::PressedKeys keys) -> std::pair<entity::GameEventTypes, std::shared_ptr<entity::GameEvent>> {
-		const bool moved = player->direct_player(keys, camera->get_direction(), camera->get_up_vec());
-		if(moved){ 
-			int n_removed = collision_map->remove_mover(player);
-			assert(n_removed == 1);
-
-			const auto player_dx = player->get_parcial_direction_x();
-			const auto collided_with_dx = collision_map->colide_direction(player,player_dx);
-			if(collided_with_dx == nullptr){
-				if(!outside_map(player, player_dx, generator->get_map_size(), generator->get_tile_size())){
-					player->translate_direction(player_dx, delta_time);
-				}
-			}else{
-				const auto resulting_event = collided_with_dx->collide(player, delta_time);
-				if(is_game_event_event(resulting_event)){
-					return std::make_pair(resulting_event, std::dynamic_pointer_cast<entity::GameEvent>(collided_with_dx));
-				}else if(resulting_event == entity::GameEventTypes::GameOver){
-					return std::make_pair(entity::GameEventTypes::GameOver, nullptr);
-				} 
-			}
-
-			const auto player_dz = player->get_parcial_direction_z();
-			const auto collided_with_dz = collision_map->colide_direction(player,player_dz);
-			if(collided_with_dz == nullptr){
-				if(!outside_map(player, player_dz, generator->get_map_size(), generator->get_tile_size())){
-					player->translate_direction(player_dz, delta_time);
-				}
-			}else{
-				const auto resulting_event = collided_with_dz->collide(player, delta_time);
-				if(is_game_event_event(resulting_event)){
-					return std::make_pair(resulting_event, std::dynamic_pointer_cast<entity::GameEvent>(collided_with_dz));
-				}else if(resulting_event == entity::GameEventTypes::GameOver){
-					return std::make_pair(entity::GameEventTypes::GameOver, nullptr);
-				} 
-			}
-
-			collision_map->insert_mover(player);
-		}
-		return std::make_pair(entity::GameEventTypes::None, nullptr);
-	}
-
-	auto GameLoop::update_enemies(float delta_time) -> entity::GameEventTypes {
-		for(auto enemy: enemies){
-			//increasse speed based on time
-			if(static_cast<int>(time) % speed_increasse_rate == 0){
-				const float enemy_speed = enemy->get_speed();
-				enemy->set_speed(enemy_speed + speed_increasse);
-			}
-
-			int n_removed = collision_map->remove_mover(enemy);
-			assert(n_removed == 1);
-			//point direction towards the player 
-			enemy->direct_towards_player(player);
-			const auto enemy_dx = enemy->get_parcial_direction_x();
-			const auto collided_with_dx = collision_map->colide_direction(enemy,enemy_dx);
-			if(collided_with_dx == nullptr){
-				enemy->translate_direction(enemy_dx, delta_time);
-			}else{
-				const auto resulting_state = collided_with_dx->collide(enemy, delta_time);
-				if(is_game_event_event(resulting_state)){
-					enemy->translate_direction(enemy_dx, delta_time);
-				}else if(resulting_state == entity::GameEventTypes::GameOver){
-					return entity::GameEventTypes::GameOver;
-				} 
-			}
-
-			const auto enemy_dz = enemy->get_parcial_direction_z();
-			const auto collided_with_dz = collision_map->colide_direction(enemy,enemy_dz);
-			if(collided_with_dz == nullptr){
-				enemy->translate_direction(enemy_dz, delta_time);
-			}else{
-				const auto resulting_state = collided_with_dz->collide(enemy, delta_time);
-				if(is_game_event_event(resulting_state)){
-					//enemies goes rightthrow gameEvents
-					enemy->translate_direction(enemy_dz, delta_time);
-				}else if(resulting_state == entity::GameEventTypes::GameOver){
-					return entity::GameEventTypes::GameOver;
-				} 
-			}
-
-			collision_map->insert_mover(enemy);
-		}
-		return entity::GameEventTypes::None;
-	}
-	auto GameLoop::update_camera_look_at() -> void {
-		camera->update_position(*look_at_param, player->get_cords());
+	auto GameLoop::update_camera_look_at(float alpha) -> void {
+		camera->update_position(*look_at_param, simulation->get_player()->get_interpolated_cords(alpha));
 		camera->update_aspect_ratio(*screen_ratio);
 	}
 	auto GameLoop::update_camera_free(float delta_time) -> void {
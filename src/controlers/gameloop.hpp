@@ -1,8 +1,8 @@
 #pragma once
-#include <unordered_set>
+#include <unordered_map>
 #include <memory>
 #include <iostream>
-#include <utility>
+#include <string>
 // Headers das bibliotecas OpenGL
 #include <glad/glad.h>   // Criação de contexto OpenGL 3.3
 #include <GLFW/glfw3.h>  // Criação de janelas do sistema operacional
@@ -11,9 +11,11 @@
 #include "../entities/camera.hpp"
 #include "../entities/screen.hpp"
 #include "../renders/shader.hpp"
-#include "collision.hpp"
-#include "generator.hpp"
+#include "simulation.hpp"
+#include "input.hpp"
+#include "replay.hpp"
 #include "../utils/matrix.hpp"
+#include "../utils/sim_clock.hpp"
 
 namespace controler{
 	enum class GameState{
@@ -27,13 +29,23 @@ namespace controler{
 		double x, y;
 		bool clicked;
 	}CursorState;
+	//the input of the window: the keys set by the glfw callbacks, moving along the camera direction
+	class LiveInput : public InputSource{
+		public:
+			LiveInput(entity::PressedKeys *keys, entity::Camera *camera): keys(keys), camera(camera){}
+			virtual auto next() -> TickInput override {
+				return TickInput{*keys, camera->get_direction(), camera->get_up_vec()};
+			}
+		private:
+			entity::PressedKeys *keys;
+			entity::Camera *camera;
+	};
 
+	//the window side of the game: menus, camera, render and input, the game itself is in the Simulation
 	class GameLoop{
 	public:
 		GameLoop(std::unique_ptr<entity::Camera> _camera,
-			std::unique_ptr<CollisionMap> _collision_map,
-			std::unique_ptr<Generator> _generator,
-			std::shared_ptr<entity::Player> _player,
+			std::unique_ptr<Simulation> _simulation,
 			std::shared_ptr<render::GPUprogram> phong_phong,
 			std::shared_ptr<render::GPUprogram> phong_diffuse,
 			std::shared_ptr<render::GPUprogram> gouraud_phong,
@@ -47,50 +59,45 @@ namespace controler{
 			float *screen_ratio, bool *paused,
 			GLFWwindow *window);  
 		~GameLoop();
-		/*updates to the next gameMoment*/ 
-		auto update(float delta_time) -> void; 
-
-		auto insert_enemy(std::shared_ptr<entity::Enemy> enemy) -> void;
-		auto insert_wall(std::shared_ptr<entity::Wall> wall) -> void;
-		auto insert_game_event(std::shared_ptr<entity::GameEvent> game_event) -> void;
-		auto insert_background(std::shared_ptr<entity::Entity> bg) -> void;
-		
-		auto remove_enemy(std::shared_ptr<entity::Enemy> enemy) -> void;
-		auto remove_wall(std::shared_ptr<entity::Wall> wall) -> void;
-		auto remove_game_event(std::shared_ptr<entity::GameEvent> game_event) -> void;
-		auto remove_background(std::shared_ptr<entity::Entity> bg) -> void;
+		/*updates to the next gameMoment, frame_seconds is the real time since the last call*/ 
+		auto update(float frame_seconds) -> void; 
 
 		inline auto insert_screen(GameState state, std::shared_ptr<entity::Screen> screen) -> void { screens[state] = screen; }
 		inline auto set_draw_bbox(bool cond) -> void { draw_bbox = cond; }
+		//ticks of the simulation per second, and how many it runs at most in a frame to catch up
+		inline auto set_tick_rate(float hz, int max_catch_up) -> void {
+			sim_clock.set_tick_rate(hz);
+			sim_clock.set_max_steps(max_catch_up);
+		}
+		//where the ticks take the player input from, the window by default
+		inline auto set_input_source(std::unique_ptr<InputSource> source) -> void { input = std::move(source); }
+		//writes the seed and the input of every tick to path, throws if it can't
+		auto record_input(const std::string &path) -> void;
+		//plays a recording instead of the window input, with its seed and tick rate, throws if it can't
+		auto replay_input(const std::string &path) -> void;
+		inline auto get_simulation() -> Simulation& { return *simulation; }
 	private:
-		auto render_frame() -> void;
-		auto render_bbox() -> void;
+		//alpha is how far the frame is between the last two ticks
+		auto render_frame(float alpha) -> void;
+		auto render_bbox(float alpha) -> void;
 
 		auto update_screen(GameState type) -> void;
-		auto update_playing(float delta_time) -> void;
+		auto update_playing(float frame_seconds) -> void;
+		//one fixed step of the simulation
+		auto tick(float delta_time) -> void;
 		
 		auto setup_playing_state() -> void;
 		auto clear_playing_state() -> void;
 
-		auto update_player(float delta_time, entity::PressedKeys keys) -> std::pair<entity::GameEventTypes, std::shared_ptr<entity::GameEvent>>;
-		auto update_enemies(float delta_time) -> entity::GameEventTypes;
-		auto update_camera_look_at() -> void;
+		auto update_camera_look_at(float alpha) -> void;
 		auto update_camera_free(float delta_time) -> void;
 
-		/*changes the game state based on the game event*/
-		auto handle_event(entity::GameEventTypes game_event_type, std::shared_ptr<entity::GameEvent> game_event) -> void;
-		auto is_game_event_event(entity::GameEventTypes game_event_type) -> bool;
+		/*changes the game state when the round ends*/
+		auto handle_event(entity::GameEventTypes game_event_type) -> void;
 
 		std::unique_ptr<entity::Camera> camera;
-		std::unique_ptr<CollisionMap> collision_map;
-		std::unique_ptr<Generator> generator;
-
-		//entities
-		std::shared_ptr<entity::Player> player;
-		std::unordered_set<std::shared_ptr<entity::Enemy>> enemies;
-		std::unordered_set<std::shared_ptr<entity::Wall>> walls;
-		std::unordered_set<std::shared_ptr<entity::GameEvent>> game_events;
-		std::unordered_set<std::shared_ptr<entity::Entity>> background;
+		std::unique_ptr<Simulation> simulation;
+		std::unique_ptr<InputSource> input;
 
 		//render stuff
 		std::shared_ptr<render::GPUprogram> phong_phong;
@@ -116,13 +123,10 @@ namespace controler{
 		//FIXME: change to mainMenu when done with the screens
 		GameState state = GameState::MainMenu;
 
-		int score;
+		//time of the menus, the simulation keeps its own
 		float time = 0;
+		utils::SimClock sim_clock{60.0f, 5};
 		float cursor_delay = 0;
-		int spawn_rate = 200;
-
-		int speed_increasse_rate = 200;
-		float speed_increasse = 0.0025f;
 
 		bool draw_bbox = true;
 
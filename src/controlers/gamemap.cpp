@@ -89,7 +89,7 @@ namespace controler{
 		}
 		//std::cout << "last item val is " << last_item << std::endl;
 		//returns a random cell amongst the one's with least entropy
-		return entropies.at(rand() % last_item).first;
+		return entropies.at(random.below(last_item)).first;
 	}
 	auto WaveFuncMap::propagate(int idx) -> void {
 		const auto neighbors = get_neighbors(idx);
@@ -128,7 +128,7 @@ namespace controler{
 
 	auto WaveFuncMap::collapse_cell(int idx) -> void {
 		//std::cout << "cell to collapse with idx " << idx << std::endl;
-		int tile_pos = rand() % wave_map.at(idx).entropy;
+		int tile_pos = random.below(wave_map.at(idx).entropy);
 
 		const char tile = wave_map[idx].vals.at(tile_pos);;
 
@@ -163,13 +163,13 @@ namespace controler{
 
 	auto WaveFuncMap::place_end_point() -> void {
 		//jeito unga bunga de fazer
-		int rand_pos = rand() % (size * size);
+		int rand_pos = random.below(size * size);
 		const int tries = 10;
 		for(int i = 0; i < tries; i++){
 			if(!wave_map.at(rand_pos).collapsed){
 				break;
 			}
-			rand_pos = rand() % (size * size);
+			rand_pos = random.below(size * size);
 		}
 		wave_map.at(rand_pos).collapsed = true;
 		wave_map.at(rand_pos).entropy = 1;
@@ -5,6 +5,9 @@
 #include <list>
 #include <vector>
 #include <memory>
+#include <cstdint>
+
+#include "../utils/random.hpp"
 
 namespace controler{
 	typedef struct cell{
@@ -27,6 +30,7 @@ namespace controler{
 
 			inline auto set_size(int _size) -> void {size = _size;}
 			inline auto set_number_end_points(int n) -> void {number_end_points = n;}
+			inline auto set_seed(uint64_t seed) -> void { random.seed(seed); }
 
 		private:
 			auto reset() -> void;
@@ -43,6 +47,7 @@ namespace controler{
 			int number_end_points;
 
 			std::vector<Cell> wave_map;
+			utils::Random random;
 
 			std::unordered_map<char,std::vector<std::unordered_set<char>>> adjecency = {
 				{' ',  {
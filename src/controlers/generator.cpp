@@ -19,6 +19,11 @@ namespace controler{
 	gouraud_phong(gouraud_phong), gouraud_diffuse(gouraud_diffuse), wire_renderer(wire_renderer),
 	cube_wire_mesh(cube_wire_mesh), cylinder_wire_mesh(cylinder_wire_mesh),
 	map_size(size), tile_size(tile_size), wave_map(WaveFuncMap(map_size, 2)){
+		set_seed(0);
+	}
+	Generator::Generator(int size, float tile_size):
+	map_size(size), tile_size(tile_size), wave_map(WaveFuncMap(map_size, 2)){
+		set_seed(0);
 	}
 	Generator::~Generator(){}
 
@@ -45,7 +50,7 @@ namespace controler{
 					new entity::Entity(
 						glm::vec4(x_pos,-1.0f,z_pos,1.0f),
 						phong_diffuse,
-						tile_meshes.at(tile_val)
+						get_tile_mesh(tile_val)
 					)
 				);
 				tile->set_scale(tile_size, 1, tile_size);
@@ -59,7 +64,7 @@ namespace controler{
 						new entity::Wall(
 							glm::vec4(x_pos, 0.0f, z_pos, 1.0f),
 							phong_phong,
-							meshes.at(static_cast<int>(MeshIds::HOUSE))
+							get_mesh(MeshIds::HOUSE)
 						)
 					);
 					wall->set_wire_mesh(cube_wire_mesh);
@@ -79,7 +84,7 @@ namespace controler{
 						new entity::GameEvent(
 							glm::vec4(x_pos, 0.0f, z_pos, 1.0f),
 							gouraud_phong,
-							meshes.at(static_cast<int>(MeshIds::CAR)),
+							get_mesh(MeshIds::CAR),
 							entity::GameEventTypes::EndPoint
 						)
 					);
@@ -96,13 +101,13 @@ namespace controler{
 				}
 				if(tile_val == '-' || tile_val == '+' || tile_val == '|'){
 					//random chance to spawn apoint in a road
-					if((rand() % 5) == 0){
+					if(pickup_random.below(5) == 0){
 						//std::cout << "ADD POINT" << std::endl;
 						std::shared_ptr<entity::GameEvent> point(
 							new entity::GameEvent(
 								glm::vec4(x_pos, 0.0f, z_pos, 1.0f),
 								phong_phong,
-								meshes.at(static_cast<int>(MeshIds::POINT)),
+								get_mesh(MeshIds::POINT),
 								entity::GameEventTypes::Point
 							)
 						);
@@ -146,29 +151,44 @@ namespace controler{
 		}
 	}
 	auto Generator::get_vacant_position() -> glm::vec4 {
-		const int rand_pos = rand() % vacant_tile.size();
+		const int rand_pos = placement_random.below(vacant_tile.size());
 		const int tile_idx = vacant_tile.at(rand_pos);
 		const int x = tile_idx % map_size;
 		const int z = (tile_idx - x) / map_size;
 
 		return glm::vec4(x * (2 * tile_size) + (tile_size/2), 0.0f, z * (2 * tile_size) + (tile_size/2), 1.0f);
 	}
+	auto Generator::set_seed(uint64_t session_seed) -> void {
+		wave_map.set_seed(utils::Random::derive(session_seed, utils::RandomStream::Map));
+		pickup_random.seed(utils::Random::derive(session_seed, utils::RandomStream::Pickups));
+		placement_random.seed(utils::Random::derive(session_seed, utils::RandomStream::Placement));
+	}
+	auto Generator::get_mesh(MeshIds id) const -> std::shared_ptr<render::Mesh> {
+		const auto it = meshes.find(static_cast<int>(id));
+		return it == meshes.end() ? nullptr : it->second;
+	}
+	auto Generator::get_tile_mesh(char tile) const -> std::shared_ptr<render::Mesh> {
+		const auto it = tile_meshes.find(tile);
+		return it == tile_meshes.end() ? nullptr : it->second;
+	}
 	auto Generator::generate_enemy(int type) -> std::shared_ptr<entity::Enemy> {
-		auto pos = get_vacant_position();
-
-		std::shared_ptr<entity::Enemy> enemy(new entity::Enemy(pos, phong_phong, meshes[type]));
-
-		enemy->set_wire_mesh(cylinder_wire_mesh);
-		enemy->set_wire_renderer(wire_renderer);
-
-		enemy->set_scale(0.2f,0.2f,0.2f);
-		enemy->set_base_translate(0.0f,-4.5f,0.0f);
-		enemy->set_base_direction(glm::vec4(0.0f,0.0f,1.0f,0.0f));
-		enemy->set_bbox_type(entity::BBoxType::Cylinder);
-		enemy->set_bbox_size(1.0f,2.0f,1.0f);
-
-		enemy->set_speed(0.05f);
-
-		return enemy;
+		return get_enemy_archetype(type).make(get_vacant_position());
+	}
+	auto Generator::get_enemy_archetype(int type) -> EnemyArchetype {
+		EnemyArchetype archetype;
+		archetype.gpu_program = phong_phong;
+		archetype.mesh = get_mesh(static_cast<MeshIds>(type));
+		archetype.wire_mesh = cylinder_wire_mesh;
+		archetype.wire_renderer = wire_renderer;
+
+		archetype.scale = glm::vec4(0.2f,0.2f,0.2f,0.0f);
+		archetype.base_translate = glm::vec4(0.0f,-4.5f,0.0f,0.0f);
+		archetype.base_direction = glm::vec4(0.0f,0.0f,1.0f,0.0f);
+		archetype.bbox_type = entity::BBoxType::Cylinder;
+		archetype.bbox_size = glm::vec4(1.0f,2.0f,1.0f,0.0f);
+
+		archetype.speed = 0.05f;
+		archetype.damage = 1;
+		return archetype;
 	}
-}
\ No newline at end of file
+}
@@ -3,11 +3,14 @@
 #include <vector>
 #include <unordered_map>
 #include <utility>
+#include <cstdint>
 
 #include "../renders/mesh.hpp"
 #include "../renders/shader.hpp"
 #include "../entities/entity.hpp"
 #include "gamemap.hpp"
+#include "spawner.hpp"
+#include "../utils/random.hpp"
 
 namespace controler{
 	struct MapElements{
@@ -34,12 +37,18 @@ namespace controler{
 				std::shared_ptr<render::WireMesh> cylinder_wire_mesh,
 				int size, float tile_size
 			);
+			//without render resources, the entities it makes have no mesh or gpu program
+			Generator(int size, float tile_size);
 			~Generator();
 
 			auto generate_map_elements(int end_points) -> struct MapElements;
 			auto generate_enemy(int type) -> std::shared_ptr<entity::Enemy>;
+			//how the enemies of the type are set up, for the EnemyPool
+			auto get_enemy_archetype(int type) -> EnemyArchetype;
 
 			auto get_vacant_position() -> glm::vec4;
+			//the map, the pickups and the placements each get a stream derived from the seed of the session
+			auto set_seed(uint64_t session_seed) -> void;
 
 			inline auto insert_mesh(int mesh_id, std::shared_ptr<render::Mesh> mesh) -> void {
 				meshes[mesh_id] = mesh;
@@ -49,10 +58,14 @@ namespace controler{
 			}
 			inline auto get_map_size() -> float { return float(map_size); }
 			inline auto get_tile_size() -> float { return float(tile_size); }
+			inline auto get_char_map() const -> const std::vector<char>& { return char_map; }
 
 		private:
 			auto generate_vacant_tiles() -> void;
 			auto generate_char_map(int end_points) -> void;
+			//nullptr when the mesh was not inserted, so it works without the render
+			auto get_mesh(MeshIds id) const -> std::shared_ptr<render::Mesh>;
+			auto get_tile_mesh(char tile) const -> std::shared_ptr<render::Mesh>;
 
 			std::unordered_map<int, std::shared_ptr<render::Mesh>> meshes;
 
@@ -71,6 +84,8 @@ namespace controler{
 			WaveFuncMap wave_map;
 			std::vector<char> char_map;
 			std::vector<int> vacant_tile;
+			utils::Random pickup_random;
+			utils::Random placement_random;
 			std::unordered_map<char, std::shared_ptr<render::Mesh>> tile_meshes;
 	};
 
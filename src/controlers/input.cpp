@@ -0,0 +1,30 @@
+#include "input.hpp"
+
+#include <cmath>
+
+namespace controler{
+	auto ScriptedInput::add_step(int ticks, entity::PressedKeys keys, float yaw) -> void {
+		const glm::vec4 view_dir(sinf(yaw), 0.0f, cosf(yaw), 0.0f);
+		steps.push_back(Step{ticks < 1 ? 1 : ticks, TickInput{keys, view_dir, glm::vec4(0.0f,1.0f,0.0f,0.0f)}});
+	}
+	auto ScriptedInput::clear() -> void {
+		steps.clear();
+		rewind();
+	}
+	auto ScriptedInput::rewind() -> void {
+		current = 0;
+		ticks_in_step = 0;
+	}
+	auto ScriptedInput::next() -> TickInput {
+		if(steps.empty()){
+			return TickInput{entity::PressedKeys{false,false,false,false},
+				glm::vec4(0.0f,0.0f,1.0f,0.0f), glm::vec4(0.0f,1.0f,0.0f,0.0f)};
+		}
+		const auto input = steps[current].input;
+		if(++ticks_in_step >= steps[current].ticks){
+			ticks_in_step = 0;
+			current = (current + 1) % static_cast<int>(steps.size());
+		}
+		return input;
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+#include "../entities/entity.hpp"
+
+namespace controler{
+	//what the player does in a tick, the keys move it relative to the view direction
+	struct TickInput{
+		entity::PressedKeys keys;
+		glm::vec4 view_dir;
+		glm::vec4 up_vec;
+	};
+	//the menu clicks that start and end the rounds, the ticks of a round come after its Start
+	enum class RoundEvent{
+		None,
+		Start,
+		Exit
+	};
+	//where the simulation gets the input of each tick from: the window, a script, a replay...
+	class InputSource{
+		public:
+			virtual ~InputSource(){}
+			//the input of the next tick
+			virtual auto next() -> TickInput = 0;
+			//called every menu frame with what the player clicked, gives back what to do: a recording writes it down,
+			//a replay gives the recorded one instead
+			virtual auto round_event(RoundEvent clicked) -> RoundEvent { return clicked; }
+	};
+	/*
+	Input read from a list of steps, each one held for some ticks, for running without a window.
+	The script starts over when it ends.
+		ScriptedInput script;
+		script.add_step(120, entity::PressedKeys{true,false,false,false}, 0.0f);
+		script.add_step(60, entity::PressedKeys{false,false,false,true}, PI/2);
+		simulation.tick(delta_time, script.next());
+	*/
+	class ScriptedInput : public InputSource{
+		public:
+			//yaw is the angle of the view direction around the up vector, 0 looks to +z
+			auto add_step(int ticks, entity::PressedKeys keys, float yaw) -> void;
+			auto clear() -> void;
+			//back to the first step
+			auto rewind() -> void;
+
+			virtual auto next() -> TickInput override;
+		private:
+			struct Step{
+				int ticks;
+				TickInput input;
+			};
+			std::vector<Step> steps;
+			int current = 0;
+			int ticks_in_step = 0;
+	};
+}
@@ -0,0 +1,173 @@
+#include "narrowphase.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define NARROWPHASE_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace controler{
+	auto CandidateBatch::clear() -> void {
+		count = 0;
+		entities.clear();
+	}
+
+	auto CandidateBatch::push(entity::Entity *candidate) -> void {
+		const int padded = (count + 4) & ~3;
+		if(static_cast<int>(x.size()) < padded){
+			x.resize(padded, 0.0f);
+			z.resize(padded, 0.0f);
+			x_radius.resize(padded, 0.0f);
+			z_radius.resize(padded, 0.0f);
+			is_box.resize(padded, 0.0f);
+		}
+		const auto cords = candidate->get_cords();
+		x[count] = cords.x;
+		z[count] = cords.z;
+		x_radius[count] = candidate->get_x_radius();
+		z_radius[count] = candidate->get_z_radius();
+		is_box[count] = candidate->get_bbox_type() == entity::BBoxType::Rectangle ? 1.0f : 0.0f;
+		entities.push_back(candidate);
+		count++;
+	}
+
+	auto CandidateBatch::take_hits(const Probe &probe, std::vector<entity::Entity*> &out) -> void {
+		int kept = 0;
+		for(int i = 0; i < count; i++){
+			if(test_one(probe, i)){
+				out.push_back(entities[i]);
+				continue;
+			}
+			x[kept] = x[i];
+			z[kept] = z[i];
+			x_radius[kept] = x_radius[i];
+			z_radius[kept] = z_radius[i];
+			is_box[kept] = is_box[i];
+			entities[kept] = entities[i];
+			kept++;
+		}
+		count = kept;
+		entities.resize(kept);
+	}
+
+	/*
+	The four shape pairs, the same math the CollisionMap used to do pair by pair.
+	The cylinders are tested by taking the point of the target's ellipse that faces the other center.
+	*/
+	auto CandidateBatch::test_one(const Probe &probe, int i) const -> bool {
+		const float gx = x[i];
+		const float gz = z[i];
+		const float box_x = x_radius[i];
+		const float box_z = z_radius[i];
+
+		if(probe.type == entity::BBoxType::Rectangle){
+			if(is_box[i] != 0.0f){
+				//solution taken from stackoverflow https://stackoverflow.com/a/62852710
+				return std::max(gx - box_x, probe.x - probe.x_radius) < std::min(gx + box_x, probe.x + probe.x_radius) &&
+					std::max(gz - box_z, probe.z - probe.z_radius) < std::min(gz + box_z, probe.z + probe.z_radius);
+			}
+			const float ca = probe.x - gx;
+			const float co = probe.z - gz;
+			const float hipotenuse = sqrtf(co*co + ca*ca);
+			const float point_x = gx + probe.x_radius * (ca / hipotenuse);
+			const float point_z = gz + probe.z_radius * (co / hipotenuse);
+
+			return point_x >= probe.x - probe.x_radius && point_x <= probe.x + probe.x_radius &&
+				point_z >= probe.z - probe.z_radius && point_z <= probe.z + probe.z_radius;
+		}
+		const float ca = gx - probe.x;
+		const float co = gz - probe.z;
+		const float hipotenuse = sqrtf(co*co + ca*ca);
+		const float point_x = probe.x + probe.x_radius * (ca / hipotenuse);
+		const float point_z = probe.z + probe.z_radius * (co / hipotenuse);
+
+		if(is_box[i] != 0.0f){
+			return point_x >= gx - box_x && point_x <= gx + box_x &&
+				point_z >= gz - box_z && point_z <= gz + box_z;
+		}
+		const float dx = gx - point_x;
+		const float dz = gz - point_z;
+		return sqrtf(dx*dx + dz*dz) <= box_x;
+	}
+
+#ifdef NARROWPHASE_SSE
+	//lanes where mask is set take a, the others take b
+	inline auto select(__m128 mask, __m128 a, __m128 b) -> __m128 {
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+	inline auto in_range(__m128 p, __m128 lo, __m128 hi) -> __m128 {
+		return _mm_and_ps(_mm_cmpge_ps(p, lo), _mm_cmple_ps(p, hi));
+	}
+
+	auto CandidateBatch::first_hit(const Probe &probe) const -> int {
+		const __m128 px = _mm_set1_ps(probe.x);
+		const __m128 pz = _mm_set1_ps(probe.z);
+		const __m128 prx = _mm_set1_ps(probe.x_radius);
+		const __m128 prz = _mm_set1_ps(probe.z_radius);
+		const __m128 zero = _mm_setzero_ps();
+		const bool probe_is_box = probe.type == entity::BBoxType::Rectangle;
+
+		for(int i = 0; i < count; i += 4){
+			const __m128 gx = _mm_loadu_ps(&x[i]);
+			const __m128 gz = _mm_loadu_ps(&z[i]);
+			const __m128 box_x = _mm_loadu_ps(&x_radius[i]);
+			const __m128 box_z = _mm_loadu_ps(&z_radius[i]);
+			const __m128 box_mask = _mm_cmpneq_ps(_mm_loadu_ps(&is_box[i]), zero);
+
+			__m128 hit;
+			if(probe_is_box){
+				const __m128 box_hit = _mm_and_ps(
+					_mm_cmplt_ps(_mm_max_ps(_mm_sub_ps(gx, box_x), _mm_sub_ps(px, prx)), _mm_min_ps(_mm_add_ps(gx, box_x), _mm_add_ps(px, prx))),
+					_mm_cmplt_ps(_mm_max_ps(_mm_sub_ps(gz, box_z), _mm_sub_ps(pz, prz)), _mm_min_ps(_mm_add_ps(gz, box_z), _mm_add_ps(pz, prz))));
+
+				const __m128 ca = _mm_sub_ps(px, gx);
+				const __m128 co = _mm_sub_ps(pz, gz);
+				const __m128 hipotenuse = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(co, co), _mm_mul_ps(ca, ca)));
+				const __m128 point_x = _mm_add_ps(gx, _mm_mul_ps(prx, _mm_div_ps(ca, hipotenuse)));
+				const __m128 point_z = _mm_add_ps(gz, _mm_mul_ps(prz, _mm_div_ps(co, hipotenuse)));
+				const __m128 cilinder_hit = _mm_and_ps(
+					in_range(point_x, _mm_sub_ps(px, prx), _mm_add_ps(px, prx)),
+					in_range(point_z, _mm_sub_ps(pz, prz), _mm_add_ps(pz, prz)));
+
+				hit = select(box_mask, box_hit, cilinder_hit);
+			}else{
+				const __m128 ca = _mm_sub_ps(gx, px);
+				const __m128 co = _mm_sub_ps(gz, pz);
+				const __m128 hipotenuse = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(co, co), _mm_mul_ps(ca, ca)));
+				const __m128 point_x = _mm_add_ps(px, _mm_mul_ps(prx, _mm_div_ps(ca, hipotenuse)));
+				const __m128 point_z = _mm_add_ps(pz, _mm_mul_ps(prz, _mm_div_ps(co, hipotenuse)));
+
+				const __m128 box_hit = _mm_and_ps(
+					in_range(point_x, _mm_sub_ps(gx, box_x), _mm_add_ps(gx, box_x)),
+					in_range(point_z, _mm_sub_ps(gz, box_z), _mm_add_ps(gz, box_z)));
+
+				const __m128 dx = _mm_sub_ps(gx, point_x);
+				const __m128 dz = _mm_sub_ps(gz, point_z);
+				const __m128 cilinder_hit = _mm_cmple_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz))), box_x);
+
+				hit = select(box_mask, box_hit, cilinder_hit);
+			}
+			//drops the padding lanes past the end
+			const int valid = count - i < 4 ? (1 << (count - i)) - 1 : 0xF;
+			const int lanes = _mm_movemask_ps(hit) & valid;
+			if(lanes != 0){
+				int lane = 0;
+				while(!(lanes & (1 << lane))) lane++;
+				return i + lane;
+			}
+		}
+		return -1;
+	}
+#else
+	auto CandidateBatch::first_hit(const Probe &probe) const -> int {
+		for(int i = 0; i < count; i++){
+			if(test_one(probe, i)){
+				return i;
+			}
+		}
+		return -1;
+	}
+#endif
+}
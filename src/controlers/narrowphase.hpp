@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+#include "../entities/entity.hpp"
+
+namespace controler{
+	//bbox of the entity that is moving, at the place it wants to go
+	struct Probe{
+		float x, z;
+		float x_radius, z_radius;
+		entity::BBoxType type;
+	};
+	inline auto make_probe(const entity::Entity &target, const glm::vec4 &future_pos) -> Probe {
+		return Probe{future_pos.x, future_pos.z, target.get_x_radius(), target.get_z_radius(), target.get_bbox_type()};
+	}
+	/*
+	The candidates of a query gathered as arrays (SoA), so they can be tested 4 at a time with SSE.
+	Without SSE it falls back to testing one by one, the results are the same.
+	The batch only points to the entities, it must not outlive the cells it was gathered from.
+	*/
+	class CandidateBatch{
+		public:
+			auto clear() -> void;
+			auto push(entity::Entity *candidate) -> void;
+
+			//index of the first candidate that collides with the probe, -1 if none does
+			auto first_hit(const Probe &probe) const -> int;
+			//takes out the candidates that collide with the probe and appends them to out, the others keep their order
+			auto take_hits(const Probe &probe, std::vector<entity::Entity*> &out) -> void;
+
+			inline auto size() const -> int { return count; }
+			inline auto get(int i) const -> entity::Entity* { return entities[i]; }
+		private:
+			auto test_one(const Probe &probe, int i) const -> bool;
+
+			int count = 0;
+			//padded to a multiple of 4 so the last lanes can always be loaded
+			std::vector<float> x, z;
+			std::vector<float> x_radius, z_radius;
+			std::vector<float> is_box; //0 or 1, used as a lane mask
+			std::vector<entity::Entity*> entities;
+	};
+}
@@ -0,0 +1,113 @@
+#include "occupancy.hpp"
+
+#include <algorithm>
+
+namespace controler{
+	OccupancyGrid::OccupancyGrid():
+		origin_x(0), origin_z(0), resolution(1), cols(0), rows(0){}
+
+	auto OccupancyGrid::build(const std::vector<char> &char_map, int map_size, float tile_size,
+		const std::vector<entity::Entity*> &new_walls, float new_resolution) -> std::vector<entity::Entity*> {
+		clear();
+		//the same layout the Generator uses, tile x is centered at x * (2 * tile_size) + (tile_size / 2)
+		origin_x = -(tile_size / 2);
+		origin_z = -(tile_size / 2);
+		resolution = new_resolution;
+		cols = static_cast<int>(ceilf(map_size * (2 * tile_size) / resolution));
+		rows = cols;
+		cells.assign(cols * rows, -1);
+
+		std::vector<entity::Entity*> left_out;
+		for(auto wall : new_walls){
+			const auto cords = wall->get_cords();
+			const int tile_x = static_cast<int>(floorf((cords.x - origin_x) / (2 * tile_size)));
+			const int tile_z = static_cast<int>(floorf((cords.z - origin_z) / (2 * tile_size)));
+			const bool on_house = tile_x >= 0 && tile_x < map_size && tile_z >= 0 && tile_z < map_size &&
+				char_map.at(tile_x + tile_z * map_size) == '#';
+			if(!on_house){
+				left_out.push_back(wall);
+				continue;
+			}
+			//the footprint is the bbox the wall was given, not the whole tile
+			const int x0 = std::max(0, cell_x(cords.x - wall->get_x_radius()));
+			const int x1 = std::min(cols - 1, cell_x(cords.x + wall->get_x_radius()));
+			const int z0 = std::max(0, cell_z(cords.z - wall->get_z_radius()));
+			const int z1 = std::min(rows - 1, cell_z(cords.z + wall->get_z_radius()));
+			bool overlaps = false;
+			for(int z = z0; z <= z1 && !overlaps; z++){
+				for(int x = x0; x <= x1; x++){
+					if(cells[x + z * cols] != -1){
+						overlaps = true;
+						break;
+					}
+				}
+			}
+			if(overlaps){
+				left_out.push_back(wall);
+				continue;
+			}
+			const int id = walls.size();
+			walls.push_back(wall);
+			for(int z = z0; z <= z1; z++){
+				for(int x = x0; x <= x1; x++){
+					cells[x + z * cols] = id;
+				}
+			}
+		}
+		return left_out;
+	}
+
+	auto OccupancyGrid::remove(const entity::Entity *wall) -> int {
+		auto it = std::find(walls.begin(), walls.end(), wall);
+		if(it == walls.end()){
+			return 0;
+		}
+		//the slot stays, so the ids in the cells don't change
+		const int id = it - walls.begin();
+		std::replace(cells.begin(), cells.end(), id, -1);
+		*it = nullptr;
+		return 1;
+	}
+
+	auto OccupancyGrid::clear() -> void {
+		cells.clear();
+		walls.clear();
+		cols = 0;
+		rows = 0;
+	}
+
+	auto OccupancyGrid::wall_at(float x, float z) const -> entity::Entity* {
+		const int cx = cell_x(x);
+		const int cz = cell_z(z);
+		if(cx < 0 || cx >= cols || cz < 0 || cz >= rows){
+			return nullptr;
+		}
+		const int id = cells[cx + cz * cols];
+		return id == -1 ? nullptr : walls[id];
+	}
+
+	auto OccupancyGrid::walls_in(float min_x, float min_z, float max_x, float max_z,
+		std::vector<entity::Entity*> &out) const -> void {
+		if(walls.empty()){
+			return;
+		}
+		const size_t first = out.size();
+		const int x0 = std::max(0, cell_x(min_x));
+		const int x1 = std::min(cols - 1, cell_x(max_x));
+		const int z0 = std::max(0, cell_z(min_z));
+		const int z1 = std::min(rows - 1, cell_z(max_z));
+		for(int z = z0; z <= z1; z++){
+			for(int x = x0; x <= x1; x++){
+				const int id = cells[x + z * cols];
+				if(id == -1){
+					continue;
+				}
+				//a query touches only a couple of houses, a linear search is enough
+				const auto wall = walls[id];
+				if(std::find(out.begin() + first, out.end(), wall) == out.end()){
+					out.push_back(wall);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cmath>
+
+#include <glm/vec4.hpp>
+
+#include "../entities/entity.hpp"
+
+namespace controler{
+	/*
+	Grid of the static geometry (the houses), built once from the char map when the map is generated.
+	Each cell holds the index of the wall whose bbox covers it, so finding the walls around a point
+	is an array lookup instead of a broadphase query.
+		OccupancyGrid grid;
+		grid.build(char_map, map_size, tile_size, walls, tile_size / 4);
+		grid.walls_in(x0, z0, x1, z1, out);
+	*/
+	class OccupancyGrid{
+		public:
+			OccupancyGrid();
+
+			//returns the walls that could not be placed in the grid (not on a '#' tile or overlaping another)
+			auto build(const std::vector<char> &char_map, int map_size, float tile_size,
+				const std::vector<entity::Entity*> &walls, float resolution) -> std::vector<entity::Entity*>;
+			auto remove(const entity::Entity *wall) -> int;
+			auto clear() -> void;
+
+			//wall that covers the point, nullptr if there is none
+			auto wall_at(float x, float z) const -> entity::Entity*;
+			//appends the walls that touch the rectangle, each one once
+			auto walls_in(float min_x, float min_z, float max_x, float max_z,
+				std::vector<entity::Entity*> &out) const -> void;
+
+			inline auto empty() const -> bool { return walls.empty(); }
+		private:
+			inline auto cell_x(float x) const -> int { return static_cast<int>(floorf((x - origin_x) / resolution)); }
+			inline auto cell_z(float z) const -> int { return static_cast<int>(floorf((z - origin_z) / resolution)); }
+
+			float origin_x, origin_z;
+			float resolution;
+			int cols, rows;
+
+			std::vector<int> cells; //index in walls, -1 if free
+			std::vector<entity::Entity*> walls; //owned by the Registry
+	};
+}
@@ -0,0 +1,136 @@
+#include "replay.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace controler{
+	static const char MAGIC[4] = {'F','C','G','R'};
+	static const uint8_t VERSION = 2;
+	//set on the records of round events, the keys only use the low bits
+	static const uint8_t EVENT_BIT = 0x80;
+	static const float TURN = 2 * 3.14159265f;
+
+	//little endian whatever the machine is
+	static auto write_bytes(std::ofstream &file, uint64_t value, int bytes) -> void {
+		for(int i = 0; i < bytes; i++){
+			file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+		}
+	}
+	static auto read_bytes(std::ifstream &file, int bytes, uint64_t &value) -> bool {
+		value = 0;
+		for(int i = 0; i < bytes; i++){
+			const int c = file.get();
+			if(c == EOF){
+				return false;
+			}
+			value |= static_cast<uint64_t>(c & 0xFF) << (8 * i);
+		}
+		return true;
+	}
+	static auto float_bits(float f) -> uint32_t {
+		uint32_t bits;
+		std::memcpy(&bits, &f, sizeof(bits));
+		return bits;
+	}
+	static auto bits_float(uint32_t bits) -> float {
+		float f;
+		std::memcpy(&f, &bits, sizeof(f));
+		return f;
+	}
+
+	static auto pack_keys(const entity::PressedKeys &keys) -> uint8_t {
+		return (keys.w ? 1 : 0) | (keys.a ? 2 : 0) | (keys.s ? 4 : 0) | (keys.d ? 8 : 0);
+	}
+	static auto unpack_keys(uint8_t bits) -> entity::PressedKeys {
+		return entity::PressedKeys{(bits & 1) != 0, (bits & 2) != 0, (bits & 4) != 0, (bits & 8) != 0};
+	}
+	//the yaw in 1/65536 of a turn, 0 looks to +z like ScriptedInput
+	static auto quantize_yaw(const glm::vec4 &view_dir) -> uint16_t {
+		float turns = atan2f(view_dir.x, view_dir.z) / TURN;
+		if(turns < 0.0f) turns += 1.0f;
+		return static_cast<uint16_t>(static_cast<uint32_t>(lroundf(turns * 65536.0f)) & 0xFFFF);
+	}
+	static auto make_input(uint8_t keys, uint16_t yaw) -> TickInput {
+		const float angle = yaw * (TURN / 65536.0f);
+		return TickInput{unpack_keys(keys), glm::vec4(sinf(angle), 0.0f, cosf(angle), 0.0f), glm::vec4(0.0f,1.0f,0.0f,0.0f)};
+	}
+
+	/*****************************
+		InputRecorder implementation
+	******************************/
+	InputRecorder::InputRecorder(std::unique_ptr<InputSource> source, const std::string &path, uint64_t seed, float tick_rate):
+		source(std::move(source)), file(path, std::ios::binary | std::ios::trunc){
+		if(!file){
+			throw std::runtime_error("Failed to create the recording " + path);
+		}
+		file.write(MAGIC, sizeof(MAGIC));
+		write_bytes(file, VERSION, 1);
+		write_bytes(file, float_bits(tick_rate), 4);
+		write_bytes(file, seed, 8);
+	}
+	auto InputRecorder::next() -> TickInput {
+		const auto input = source->next();
+		const uint8_t keys = pack_keys(input.keys);
+		const uint16_t new_yaw = quantize_yaw(input.view_dir);
+		//wraps around, so a turn past 0 is a small change
+		const int16_t change = static_cast<int16_t>(static_cast<uint16_t>(new_yaw - yaw));
+		yaw = new_yaw;
+
+		write_bytes(file, keys, 1);
+		write_bytes(file, static_cast<uint16_t>(change), 2);
+		ticks++;
+		return make_input(keys, yaw);
+	}
+	auto InputRecorder::round_event(RoundEvent clicked) -> RoundEvent {
+		const auto event = source->round_event(clicked);
+		if(event != RoundEvent::None){
+			write_bytes(file, EVENT_BIT | static_cast<uint8_t>(event), 1);
+			if(event == RoundEvent::Exit){
+				//the window closes after this, nothing else gets written
+				file.flush();
+			}
+		}
+		return event;
+	}
+
+	/*****************************
+		InputReplayer implementation
+	******************************/
+	InputReplayer::InputReplayer(const std::string &path): file(path, std::ios::binary){
+		char magic[4];
+		uint64_t version, rate_bits;
+		if(!file || !file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+			!read_bytes(file, 1, version) || version != VERSION ||
+			!read_bytes(file, 4, rate_bits) || !read_bytes(file, 8, seed)){
+			throw std::runtime_error("Not a recording: " + path);
+		}
+		tick_rate = bits_float(static_cast<uint32_t>(rate_bits));
+	}
+	auto InputReplayer::next() -> TickInput {
+		uint64_t keys, change;
+		const int c = done ? EOF : file.peek();
+		if(c != EOF && (c & EVENT_BIT) != 0){
+			return make_input(0, yaw);
+		}
+		if(done || !read_bytes(file, 1, keys) || !read_bytes(file, 2, change)){
+			done = true;
+			return make_input(0, yaw);
+		}
+		yaw = static_cast<uint16_t>(yaw + static_cast<uint16_t>(change));
+		ticks++;
+		return make_input(static_cast<uint8_t>(keys), yaw);
+	}
+	auto InputReplayer::round_event(RoundEvent clicked) -> RoundEvent {
+		const int c = done ? EOF : file.peek();
+		if(c == EOF){
+			done = true;
+			return clicked;
+		}
+		if((c & EVENT_BIT) == 0){
+			return RoundEvent::None;
+		}
+		file.get();
+		return static_cast<RoundEvent>(c & ~EVENT_BIT);
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+#include "input.hpp"
+
+namespace controler{
+	/*
+	Binary log of a session, to run the exact same game again (under a profiler, for example):
+		header: "FCGR", uint8 version, float tick rate, uint64 seed
+		each tick: uint8 keys (w a s d in the low bits), int16 change of the view yaw (1/65536 of a turn)
+		each round start or exit from the menus: uint8 0x80 | RoundEvent, between the ticks of the rounds
+	With the seed and the same tick rate the simulation only depends on the input, so replaying it gives the same ticks.
+		InputRecorder recorder(std::move(live_input), "session.rec", seed, 60.0f);
+		simulation.tick(delta_time, recorder.next());
+		...
+		InputReplayer replay("session.rec");
+		simulation.set_seed(replay.get_seed());
+		simulation.tick(delta_time, replay.next());
+	*/
+	//passes on the input of another source and writes it to the file
+	class InputRecorder : public InputSource{
+		public:
+			//throws if the file can't be created
+			InputRecorder(std::unique_ptr<InputSource> source, const std::string &path, uint64_t seed, float tick_rate);
+
+			//the recorded input, the view goes through the same rounding the replay does, so both see the same
+			virtual auto next() -> TickInput override;
+			virtual auto round_event(RoundEvent clicked) -> RoundEvent override;
+			inline auto get_ticks() const -> long { return ticks; }
+		private:
+			std::unique_ptr<InputSource> source;
+			std::ofstream file;
+			uint16_t yaw = 0;
+			long ticks = 0;
+	};
+	//reads the input back, after the end it gives no keys pressed and the menus go back to the clicks
+	class InputReplayer : public InputSource{
+		public:
+			//throws if the file can't be read or is not a recording
+			InputReplayer(const std::string &path);
+
+			//no keys where the recording has a round event instead, the round ended sooner there
+			virtual auto next() -> TickInput override;
+			//the clicks are ignored until the recording ends, the menus wait for its next event
+			virtual auto round_event(RoundEvent clicked) -> RoundEvent override;
+			inline auto get_seed() const -> uint64_t { return seed; }
+			inline auto get_tick_rate() const -> float { return tick_rate; }
+			inline auto finished() const -> bool { return done; }
+			inline auto get_ticks() const -> long { return ticks; }
+		private:
+			std::ifstream file;
+			uint64_t seed = 0;
+			float tick_rate = 0.0f;
+			uint16_t yaw = 0;
+			long ticks = 0;
+			bool done = false;
+	};
+}
@@ -0,0 +1,371 @@
+#include "road_planner.hpp"
+
+#include <cmath>
+#include <queue>
+#include <limits>
+#include <cstdlib>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+
+namespace controler{
+	static const int INFINITE_COST = std::numeric_limits<int>::max();
+	//right, left, down, up and the diagonals, a step to a side costs 10 and a diagonal 14
+	static const int NEIGHBOR_X[8]    = { 1, -1,  0,  0,  1,  1, -1, -1};
+	static const int NEIGHBOR_Z[8]    = { 0,  0,  1, -1,  1, -1,  1, -1};
+	static const int NEIGHBOR_COST[8] = {10, 10, 10, 10, 14, 14, 14, 14};
+
+	typedef std::pair<int, int> Entry; //cost, tile or node
+	typedef std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> OpenQueue;
+
+	RoadPlanner::RoadPlanner(std::size_t cache_size): cache(cache_size) {}
+
+	auto RoadPlanner::build(const std::vector<char> &_char_map, int map_size, float _tile_size) -> void {
+		clear();
+		size = map_size;
+		tile_size = _tile_size;
+		char_map = _char_map;
+		const int tiles = size * size;
+		node_of.assign(tiles, -1);
+		traced.assign(tiles, 0);
+
+		//the crossings and the dead ends, the tiles with other than two roads around
+		for(int tile = 0; tile < tiles; tile++){
+			if(!is_road(tile)){
+				continue;
+			}
+			int roads = 0;
+			for(int n = 0; n < 4; n++){
+				const int x = tile % size + NEIGHBOR_X[n];
+				const int z = tile / size + NEIGHBOR_Z[n];
+				roads += !is_blocked(x, z) && is_road(x + z * size);
+			}
+			if(roads != 2 || char_map[tile] == '+'){
+				add_node(tile);
+			}
+		}
+		for(int node = 0; node < static_cast<int>(nodes.size()); node++){
+			trace_edges(node);
+		}
+		//a loop of road without crossings gets a node of its own
+		for(int tile = 0; tile < tiles; tile++){
+			if(is_road(tile) && !traced[tile] && node_of[tile] == -1){
+				trace_edges(add_node(tile));
+			}
+		}
+		build_regions();
+	}
+
+	auto RoadPlanner::clear() -> void {
+		size = 0;
+		char_map.clear();
+		nodes.clear();
+		node_of.clear();
+		traced.clear();
+		region.clear();
+		region_next.clear();
+		region_cost.clear();
+		cache.clear();
+	}
+
+	auto RoadPlanner::add_node(int tile) -> int {
+		node_of[tile] = static_cast<int>(nodes.size());
+		nodes.push_back(Node{tile, std::vector<Edge>()});
+		return node_of[tile];
+	}
+
+	auto RoadPlanner::trace_edges(int node) -> void {
+		const int start = nodes[node].tile;
+		for(int n = 0; n < 4; n++){
+			int x = start % size + NEIGHBOR_X[n];
+			int z = start / size + NEIGHBOR_Z[n];
+			if(is_blocked(x, z) || !is_road(x + z * size)){
+				continue;
+			}
+			Edge edge;
+			int previous = start;
+			int current = x + z * size;
+			while(node_of[current] == -1){
+				traced[current] = 1;
+				edge.tiles.push_back(current);
+				//not a node, so there is exactly one road to go on by
+				int next = -1;
+				for(int m = 0; m < 4 && next == -1; m++){
+					x = current % size + NEIGHBOR_X[m];
+					z = current / size + NEIGHBOR_Z[m];
+					if(!is_blocked(x, z) && is_road(x + z * size) && x + z * size != previous){
+						next = x + z * size;
+					}
+				}
+				previous = current;
+				current = next;
+			}
+			edge.to = node_of[current];
+			edge.cost = 10 * (static_cast<int>(edge.tiles.size()) + 1);
+			nodes[node].edges.push_back(std::move(edge));
+		}
+	}
+
+	//dijkstra from all the nodes at once, the one that gets to a tile first owns it
+	auto RoadPlanner::build_regions() -> void {
+		const int tiles = size * size;
+		region.assign(tiles, -1);
+		region_next.assign(tiles, -1);
+		auto &cost = region_cost;
+		cost.assign(tiles, INFINITE_COST);
+		OpenQueue open;
+		for(int node = 0; node < static_cast<int>(nodes.size()); node++){
+			const int tile = nodes[node].tile;
+			cost[tile] = 0;
+			region[tile] = node;
+			open.push(Entry(0, tile));
+		}
+		while(!open.empty()){
+			const auto current = open.top();
+			open.pop();
+			const int tile = current.second;
+			if(current.first != cost[tile]){
+				continue;
+			}
+			const int x = tile % size;
+			const int z = tile / size;
+			for(int n = 0; n < 8; n++){
+				const int nx = x + NEIGHBOR_X[n];
+				const int nz = z + NEIGHBOR_Z[n];
+				//the diagonals don't cut the corner of a house
+				if(is_blocked(nx, nz) || (n >= 4 && (is_blocked(nx, z) || is_blocked(x, nz)))){
+					continue;
+				}
+				const int next = nx + nz * size;
+				const int next_cost = current.first + NEIGHBOR_COST[n];
+				if(next_cost < cost[next]){
+					cost[next] = next_cost;
+					region[next] = region[tile];
+					region_next[next] = tile;
+					open.push(Entry(next_cost, next));
+				}
+			}
+		}
+		//whoever got pushed into the side of a house leaves by the first free tile around it
+		for(int tile = 0; tile < tiles; tile++){
+			if(char_map[tile] != '#'){
+				continue;
+			}
+			for(int n = 0; n < 8; n++){
+				const int nx = tile % size + NEIGHBOR_X[n];
+				const int nz = tile / size + NEIGHBOR_Z[n];
+				if(!is_blocked(nx, nz) && region[nx + nz * size] != -1){
+					region[tile] = region[nx + nz * size];
+					region_next[tile] = nx + nz * size;
+					break;
+				}
+			}
+		}
+		link_regions();
+	}
+
+	/*
+	Roads that don't meet are still joined by the grass between them, so two regions that touch get an edge
+	between their nodes, through the pair of touching tiles that makes it the cheapest.
+	*/
+	auto RoadPlanner::link_regions() -> void {
+		struct Link{
+			int cost;
+			int from_tile;
+			int to_tile;
+		};
+		std::unordered_map<uint64_t, Link> links;
+		for(int tile = 0; tile < size * size; tile++){
+			if(char_map[tile] == '#' || region[tile] == -1){
+				continue;
+			}
+			const int x = tile % size;
+			const int z = tile / size;
+			for(int n = 0; n < 8; n++){
+				const int nx = x + NEIGHBOR_X[n];
+				const int nz = z + NEIGHBOR_Z[n];
+				if(is_blocked(nx, nz) || (n >= 4 && (is_blocked(nx, z) || is_blocked(x, nz)))){
+					continue;
+				}
+				const int next = nx + nz * size;
+				if(region[next] == region[tile] || region[next] == -1){
+					continue;
+				}
+				const uint64_t key = (static_cast<uint64_t>(region[tile]) << 32) | static_cast<uint32_t>(region[next]);
+				const int cost = region_cost[tile] + NEIGHBOR_COST[n] + region_cost[next];
+				const auto it = links.find(key);
+				if(it == links.end() || cost < it->second.cost){
+					links[key] = Link{cost, tile, next};
+				}
+			}
+		}
+		for(const auto &link : links){
+			Edge edge;
+			edge.to = region[link.second.to_tile];
+			edge.cost = link.second.cost;
+			//back from the touching tile to the node, then on from the other one to its node
+			for(int tile = link.second.from_tile; tile != -1 && node_of[tile] == -1; tile = region_next[tile]){
+				edge.tiles.push_back(tile);
+			}
+			std::reverse(edge.tiles.begin(), edge.tiles.end());
+			for(int tile = link.second.to_tile; tile != -1 && node_of[tile] == -1; tile = region_next[tile]){
+				edge.tiles.push_back(tile);
+			}
+			nodes[region[link.second.from_tile]].edges.push_back(std::move(edge));
+		}
+	}
+
+	auto RoadPlanner::plan_route(int from, int to, RoadRoute &route) -> void {
+		route.found = false;
+		route.tiles.clear();
+		const int count = static_cast<int>(nodes.size());
+		node_cost.assign(count, INFINITE_COST);
+		came_from.assign(count, std::make_pair(-1, -1));
+
+		const int goal_x = nodes[to].tile % size;
+		const int goal_z = nodes[to].tile / size;
+		//the octile distance, what it would cost with no houses in the way
+		auto heuristic = [&](int node){
+			const int dx = std::abs(nodes[node].tile % size - goal_x);
+			const int dz = std::abs(nodes[node].tile / size - goal_z);
+			return 10 * std::max(dx, dz) + 4 * std::min(dx, dz);
+		};
+		OpenQueue open;
+		node_cost[from] = 0;
+		open.push(Entry(heuristic(from), from));
+		while(!open.empty()){
+			const auto current = open.top();
+			open.pop();
+			const int node = current.second;
+			if(node == to){
+				route.found = true;
+				break;
+			}
+			if(current.first != node_cost[node] + heuristic(node)){
+				continue;
+			}
+			const auto &edges = nodes[node].edges;
+			for(int e = 0; e < static_cast<int>(edges.size()); e++){
+				const int next_cost = node_cost[node] + edges[e].cost;
+				if(next_cost < node_cost[edges[e].to]){
+					node_cost[edges[e].to] = next_cost;
+					came_from[edges[e].to] = std::make_pair(node, e);
+					open.push(Entry(next_cost + heuristic(edges[e].to), edges[e].to));
+				}
+			}
+		}
+		if(!route.found){
+			return;
+		}
+		//walks back from the goal, each edge reversed
+		for(int node = to; node != from; node = came_from[node].first){
+			route.tiles.push_back(nodes[node].tile);
+			const auto &edge = nodes[came_from[node].first].edges[came_from[node].second];
+			route.tiles.insert(route.tiles.end(), edge.tiles.rbegin(), edge.tiles.rend());
+		}
+		route.tiles.push_back(nodes[from].tile);
+		std::reverse(route.tiles.begin(), route.tiles.end());
+	}
+
+	auto RoadPlanner::find_path(const glm::vec4 &from, const glm::vec4 &to, std::vector<glm::vec4> &waypoints) -> bool {
+		waypoints.clear();
+		if(empty()){
+			return false;
+		}
+		const int start = tile_of(from.x, from.z);
+		const int goal = tile_of(to.x, to.z);
+		if(start == goal || line_of_sight(start, goal)){
+			waypoints.push_back(to);
+			return true;
+		}
+		const int start_region = region[start];
+		const int goal_region = region[goal];
+		if(start_region == -1 || goal_region == -1){
+			return false;
+		}
+		const uint64_t key = (static_cast<uint64_t>(start_region) << 32) | static_cast<uint32_t>(goal_region);
+		const RoadRoute *route = cache.get(key);
+		if(route == nullptr){
+			RoadRoute planned;
+			plan_route(start_region, goal_region, planned);
+			route = cache.put(key, std::move(planned));
+		}
+		if(!route->found){
+			return false;
+		}
+
+		//start to its node, the road, and the node of the goal to the goal
+		path_tiles.clear();
+		for(int tile = start; tile != nodes[start_region].tile; tile = region_next[tile]){
+			path_tiles.push_back(tile);
+		}
+		path_tiles.insert(path_tiles.end(), route->tiles.begin(), route->tiles.end());
+		goal_tiles.clear();
+		for(int tile = goal; tile != nodes[goal_region].tile; tile = region_next[tile]){
+			goal_tiles.push_back(tile);
+		}
+		path_tiles.insert(path_tiles.end(), goal_tiles.rbegin(), goal_tiles.rend());
+
+		//keeps only the tiles where the straight line from the last one kept stops being clear
+		const int last = static_cast<int>(path_tiles.size()) - 1;
+		int i = 0;
+		while(i < last){
+			int j = i + 1;
+			while(j < last && line_of_sight(path_tiles[i], path_tiles[j + 1])){
+				j++;
+			}
+			waypoints.push_back(j == last ? to : tile_center(path_tiles[j]));
+			i = j;
+		}
+		return true;
+	}
+
+	//walks the tiles the line goes through, when it goes exactly through a corner both sides have to be free
+	auto RoadPlanner::line_of_sight(int a, int b) const -> bool {
+		int x = a % size;
+		int z = a / size;
+		const int x_step = b % size > x ? 1 : -1;
+		const int z_step = b / size > z ? 1 : -1;
+		int dx = std::abs(b % size - x);
+		int dz = std::abs(b / size - z);
+		int error = dx - dz;
+		dx *= 2;
+		dz *= 2;
+		for(int n = 1 + (dx + dz) / 2; n > 0; n--){
+			if(is_blocked(x, z)){
+				return false;
+			}
+			if(n == 1){
+				break;
+			}
+			if(error > 0){
+				x += x_step;
+				error -= dz;
+			}else if(error < 0){
+				z += z_step;
+				error += dx;
+			}else{
+				if(is_blocked(x + x_step, z) || is_blocked(x, z + z_step)){
+					return false;
+				}
+				x += x_step;
+				z += z_step;
+				error += dx - dz;
+				n--;
+			}
+		}
+		return true;
+	}
+
+	auto RoadPlanner::tile_of(float x, float z) const -> int {
+		//the tiles are centered at i * 2 * tile_size + tile_size / 2, like the Generator places them
+		const float span = 2.0f * tile_size;
+		const int tx = std::min(std::max(static_cast<int>(floorf((x + tile_size / 2) / span)), 0), size - 1);
+		const int tz = std::min(std::max(static_cast<int>(floorf((z + tile_size / 2) / span)), 0), size - 1);
+		return tx + tz * size;
+	}
+
+	auto RoadPlanner::tile_center(int tile) const -> glm::vec4 {
+		return glm::vec4((tile % size) * 2 * tile_size + tile_size / 2, 0.0f, (tile / size) * 2 * tile_size + tile_size / 2, 1.0f);
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include <glm/vec4.hpp>
+
+#include "../utils/lru_cache.hpp"
+
+namespace controler{
+	//the road tiles from the node of one region to the node of another, both included
+	struct RoadRoute{
+		bool found;
+		std::vector<int> tiles;
+	};
+	/*
+	Paths between any two points of the map, planned in two levels.
+	The roads ('-', '|', '+') become a graph: the crossings and the dead ends are the nodes and the
+	stretches of road between them the edges. Every tile that can be walked on belongs to the region
+	of its closest node and knows the way to it, regions that touch are joined by an edge too.
+	A path goes from the start to the node of its region, along the roads to the node of the region of the goal,
+	and from there to the goal; then the corners that can be seen past are cut.
+	The road part only depends on the two regions, so it is kept in a cache.
+		RoadPlanner planner;
+		planner.build(char_map, map_size, tile_size);
+		std::vector<glm::vec4> waypoints;
+		if(planner.find_path(zombie_pos, noise_pos, waypoints)){ ... }
+	*/
+	class RoadPlanner{
+		public:
+			//routes between pairs of regions that are kept
+			RoadPlanner(std::size_t cache_size = 256);
+
+			auto build(const std::vector<char> &char_map, int map_size, float tile_size) -> void;
+			auto clear() -> void;
+
+			//points to walk through in order, the last one is to, false if there is no way
+			auto find_path(const glm::vec4 &from, const glm::vec4 &to, std::vector<glm::vec4> &waypoints) -> bool;
+			//tile of a point of the world, points outside the map go to the nearest tile
+			auto tile_of(float x, float z) const -> int;
+
+			inline auto empty() const -> bool { return size == 0; }
+			inline auto get_node_count() const -> int { return static_cast<int>(nodes.size()); }
+			//node of the region of the tile, -1 if no road can be reached from it
+			inline auto get_region(int tile) const -> int { return region[tile]; }
+			inline auto get_cache() const -> const utils::LruCache<uint64_t, RoadRoute>& { return cache; }
+		private:
+			struct Edge{
+				int to;
+				int cost;
+				std::vector<int> tiles; //the road between the two nodes
+			};
+			struct Node{
+				int tile;
+				std::vector<Edge> edges;
+			};
+
+			inline auto is_road(int tile) const -> bool {
+				return char_map[tile] == '-' || char_map[tile] == '|' || char_map[tile] == '+';
+			}
+			inline auto is_blocked(int x, int z) const -> bool {
+				return x < 0 || x >= size || z < 0 || z >= size || char_map[x + z * size] == '#';
+			}
+			auto add_node(int tile) -> int;
+			//follows the road out of the node on each side until the next node
+			auto trace_edges(int node) -> void;
+			//the region of each tile and the way to its node
+			auto build_regions() -> void;
+			auto link_regions() -> void;
+			//A* over the nodes
+			auto plan_route(int from, int to, RoadRoute &route) -> void;
+			//a straight line between the centers doesn't cross a house
+			auto line_of_sight(int a, int b) const -> bool;
+			auto tile_center(int tile) const -> glm::vec4;
+
+			int size = 0;
+			float tile_size = 1.0f;
+			std::vector<char> char_map;
+			std::vector<Node> nodes;
+			std::vector<int> node_of;       //node of a tile, -1 if it isn't one
+			std::vector<unsigned char> traced;
+			std::vector<int> region;        //by tile
+			std::vector<int> region_next;   //next tile towards the node of the region
+			std::vector<int> region_cost;   //walking cost to the node of the region
+			utils::LruCache<uint64_t, RoadRoute> cache;
+
+			//reused by find_path and plan_route
+			std::vector<int> path_tiles;
+			std::vector<int> goal_tiles;
+			std::vector<int> node_cost;
+			std::vector<std::pair<int, int>> came_from; //node and index of the edge it was reached by
+	};
+}
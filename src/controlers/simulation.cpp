@@ -0,0 +1,566 @@
+#include "simulation.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace controler{
+	inline auto outside_map(const entity::Player *player, const glm::vec4 dir, const float map_size, const float tile_size) -> bool{
+		const auto pos = player->get_cords() + dir;
+		const float bx = player->get_x_radius();
+		const float bz = player->get_z_radius();
+		const float max_border = map_size * (2 * tile_size) - (tile_size / 2) ;
+		const float min_border = -(tile_size / 2);
+
+		return (pos.x < min_border + bx) || (pos.x > max_border - bx) || (pos.z < min_border + bz) || (pos.z > max_border - bz);
+	}
+	//the step an entity wants to take this frame, on the ground plane
+	inline auto step_displacement(const entity::Entity *entity, float delta_time) -> glm::vec4 {
+		const auto dir = entity->get_direction();
+		return glm::vec4(dir.x, 0.0f, dir.z, 0.0f) * (entity->get_speed() * delta_time);
+	}
+	//the order of the lists doesn't matter, so it swaps with the last one
+	inline auto erase_handle(std::vector<entity::Handle> &list, entity::Handle handle) -> bool {
+		auto it = std::find(list.begin(), list.end(), handle);
+		if(it == list.end()){
+			return false;
+		}
+		*it = list.back();
+		list.pop_back();
+		return true;
+	}
+
+	Simulation::Simulation(std::unique_ptr<entity::Registry> _registry,
+		std::unique_ptr<CollisionMap> _collision_map,
+		std::unique_ptr<Generator> _generator,
+		std::shared_ptr<entity::Player> _player):
+		registry(std::move(_registry)), collision_map(std::move(_collision_map)),
+		generator(std::move(_generator)), enemy_pool(*registry),
+		player(_player.get())
+	{
+		player_handle = registry->create(_player);
+		collision_map->insert_mover(player_handle);
+		zombie_archetype = enemy_pool.add_archetype(generator->get_enemy_archetype(static_cast<int>(MeshIds::ENEMY)));
+	}
+	Simulation::~Simulation(){}
+
+	auto Simulation::set_seed(uint64_t new_seed) -> void {
+		seed = new_seed;
+		generator->set_seed(seed);
+	}
+	auto Simulation::start_round() -> void {
+		auto map_elements = generator->generate_map_elements(2);
+
+		for(const auto &tile : map_elements.tiles){
+			insert_background(tile);
+		}
+		//the houses never move during a round, they go in the static grid of the collision map
+		for(const auto &wall : map_elements.walls){
+			walls.push_back(registry->create(wall));
+		}
+		collision_map->build_static(generator->get_char_map(), static_cast<int>(generator->get_map_size()), generator->get_tile_size(), walls);
+		flow_field.build(generator->get_char_map(), static_cast<int>(generator->get_map_size()), generator->get_tile_size());
+		for(const auto &ge : map_elements.game_events){
+			insert_game_event(ge);
+			if(ge->get_type() == entity::GameEventTypes::EndPoint){
+				has_car = true;
+				car_cords = ge->get_cords();
+			}
+		}
+		const auto valid_position = generator->get_vacant_position();
+		collision_map->remove_mover(player_handle);
+		player->set_cords(valid_position.x, valid_position.y, valid_position.z);
+		player->save_previous_state();
+		collision_map->insert_mover(player_handle);
+		//all the zombies the round can have are made now, the spawns during it only take them from the pool
+		const int missing = spawn_director.get_settings().max_active - enemy_pool.get_free_count(zombie_archetype);
+		if(missing > 0){
+			enemy_pool.prewarm(zombie_archetype, missing);
+		}
+		time = 0;
+	}
+	auto Simulation::find_path(const glm::vec4 &from, const glm::vec4 &to, std::vector<glm::vec4> &waypoints) -> bool {
+		//a round with no guards never asks for a path, so the graph is only built for the first one
+		if(road_planner.empty()){
+			road_planner.build(generator->get_char_map(), static_cast<int>(generator->get_map_size()), generator->get_tile_size());
+		}
+		return road_planner.find_path(from, to, waypoints);
+	}
+	auto Simulation::clear_round() -> void {
+		score = 0;
+		time = 0;
+		collision_map->clear();
+		enemy_components.clear();
+		enemy_lod.clear();
+		ai_scheduler.clear();
+		flow_field.clear();
+		road_planner.clear();
+		guards.clear();
+		spawn_count = 0;
+		has_car = false;
+		spawn_director.reset();
+		//the enemies go back to the pool for the next round
+		for(const auto handle : enemies){
+			enemy_pool.release(handle);
+		}
+		enemies.clear();
+		//more than a round can use, the spawn settings went down
+		if(enemy_pool.get_free_count(zombie_archetype) > spawn_director.get_settings().max_active){
+			enemy_pool.clear();
+		}
+		//everything else but the player belongs to the round
+		for(auto list : {&game_events, &walls, &background}){
+			for(const auto handle : *list){
+				registry->destroy(handle);
+			}
+			list->clear();
+		}
+	}
+
+	auto Simulation::tick(float delta_time, const TickInput &input) -> entity::GameEventTypes {
+		time += delta_time;
+		player->save_previous_state();
+		for(const auto handle : enemies){
+			registry->get(handle)->save_previous_state();
+		}
+		switch(spawn_director.update(delta_time, static_cast<int>(enemies.size()))){
+		case SpawnAction::Spawn:
+			spawn_enemy();
+			break;
+		case SpawnAction::Recycle:
+			recycle_far_enemy();
+			break;
+		default:
+			break;
+		}
+		const auto event_player = update_player(delta_time, input);
+		const auto result = handle_event(event_player.first, event_player.second);
+		if(result != entity::GameEventTypes::None){
+			return result;
+		}
+		return handle_event(update_enemies(delta_time), entity::Handle());
+	}
+
+	auto Simulation::handle_event(entity::GameEventTypes game_event_type, entity::Handle game_event) -> entity::GameEventTypes {
+		switch (game_event_type){
+		case entity::GameEventTypes::Point :
+			remove_game_event(game_event);
+			score++;
+			return entity::GameEventTypes::None;
+		case entity::GameEventTypes::EndPoint :
+		case entity::GameEventTypes::GameOver :
+			return game_event_type;
+		default:
+			return entity::GameEventTypes::None;
+		}
+	}
+	auto Simulation::is_game_event_event(entity::GameEventTypes game_event_type) -> bool {
+		switch (game_event_type) {
+		case entity::GameEventTypes::Point:
+			return true;
+			break;
+		case entity::GameEventTypes::EndPoint:
+			return true;
+			break;
+		default:
+			return false;
+			break;
+		}
+	}
+	auto Simulation::insert_enemy(std::shared_ptr<entity::Enemy> enemy) -> entity::Handle {
+		const auto handle = registry->create(std::move(enemy));
+		activate_enemy(handle);
+		return handle;
+	}
+	auto Simulation::activate_enemy(entity::Handle handle) -> void {
+		//it doesn't slide in from where it was before
+		registry->get(handle)->save_previous_state();
+		enemy_lod.reset(handle);
+		ai_scheduler.reset(handle);
+		//the pool gives back the same handle, a guard path of its last life stays behind
+		if(handle.index < guards.size()){
+			guards[handle.index].active = false;
+		}
+		enemies.push_back(handle);
+		collision_map->insert_mover(handle);
+		if(use_components){
+			enemy_components.add(handle, *registry->get(handle));
+		}
+	}
+	auto Simulation::spawn_enemy() -> void {
+		const auto handle = enemy_pool.acquire(zombie_archetype, generator->get_vacant_position());
+		activate_enemy(handle);
+		spawn_count++;
+		if(guard_every > 0 && spawn_count % guard_every == 0){
+			assign_guard(handle);
+		}
+	}
+	auto Simulation::recycle_far_enemy() -> void {
+		const auto player_cords = player->get_cords();
+		const float min_distance = spawn_director.get_settings().recycle_distance;
+		float farthest = min_distance * min_distance;
+		entity::Handle candidate;
+		for(const auto handle : enemies){
+			const auto d = registry->get(handle)->get_cords() - player_cords;
+			const float distance = d.x*d.x + d.z*d.z;
+			if(distance > farthest){
+				farthest = distance;
+				candidate = handle;
+			}
+		}
+		if(candidate.is_null()){
+			return;
+		}
+		//the pool gives the same enemy back
+		remove_enemy(candidate);
+		spawn_enemy();
+	}
+	auto Simulation::insert_wall(std::shared_ptr<entity::Wall> wall) -> entity::Handle {
+		const auto handle = registry->create(std::move(wall));
+		walls.push_back(handle);
+		collision_map->insert_obj(handle);
+		return handle;
+	}
+	auto Simulation::insert_game_event(std::shared_ptr<entity::GameEvent> game_event) -> entity::Handle {
+		const auto handle = registry->create(std::move(game_event));
+		game_events.push_back(handle);
+		collision_map->insert_trigger(handle);
+		return handle;
+	}
+	auto Simulation::insert_background(std::shared_ptr<entity::Entity> bg) -> entity::Handle {
+		const auto handle = registry->create(std::move(bg));
+		background.push_back(handle);
+		return handle;
+	}
+	auto Simulation::remove_enemy(entity::Handle enemy) -> void {
+		if(erase_handle(enemies, enemy)){
+			collision_map->remove_mover(enemy);
+			enemy_components.remove(enemy);
+			ai_scheduler.reset(enemy);
+			enemy_pool.release(enemy);
+		}
+	}
+	auto Simulation::remove_wall(entity::Handle wall) -> void {
+		if(erase_handle(walls, wall)){
+			collision_map->remove_obj(wall);
+			registry->destroy(wall);
+		}
+	}
+	auto Simulation::remove_game_event(entity::Handle game_event) -> void {
+		if(erase_handle(game_events, game_event)){
+			collision_map->remove_trigger(game_event);
+			registry->destroy(game_event);
+		}
+	}
+	auto Simulation::remove_background(entity::Handle bg) -> void {
+		if(erase_handle(background, bg)){
+			registry->destroy(bg);
+		}
+	}
+
+	auto Simulation::update_player(float delta_time, const TickInput &input) -> std::pair<entity::GameEventTypes, entity::Handle> {
+		auto keys = input.keys;
+		const bool moved = player->direct_player(keys, input.view_dir, input.up_vec);
+		if(moved){ 
+			//the player stays in the map, it only changes cells when it crosses one
+			const auto old_cords = player->get_cords();
+			const auto displacement = step_displacement(player, delta_time);
+			const auto sweep = collision_map->sweep(player_handle, displacement);
+
+			//goes up to the contact and slides along it
+			auto step = displacement * sweep.time + sweep.remainder;
+			if(!sweep.hit.is_null()){
+				const auto resulting_event = collision_table.resolve(*registry->get(sweep.hit), *player, delta_time);
+				if(is_game_event_event(resulting_event)){
+					collision_map->relocate(player_handle, old_cords, player->get_cords());
+					return std::make_pair(resulting_event, sweep.hit);
+				}else if(resulting_event == entity::GameEventTypes::GameOver){
+					collision_map->relocate(player_handle, old_cords, player->get_cords());
+					return std::make_pair(entity::GameEventTypes::GameOver, entity::Handle());
+				}
+				//a knock back already moved it, the slide was worked out from where it was before
+				if(player->get_cords() != old_cords){
+					step = glm::vec4(0.0f);
+				}
+			}
+			//the borders of the map are checked for each axis, so the player can slide along them
+			if(outside_map(player, glm::vec4(step.x, 0.0f, 0.0f, 0.0f), generator->get_map_size(), generator->get_tile_size())){
+				step.x = 0.0f;
+			}
+			if(outside_map(player, glm::vec4(0.0f, 0.0f, step.z, 0.0f), generator->get_map_size(), generator->get_tile_size())){
+				step.z = 0.0f;
+			}
+			player->translate(step);
+
+			collision_map->relocate(player_handle, old_cords, player->get_cords());
+
+			//game events are triggers, only the player looks for them
+			const auto trigger = collision_map->trigger_hit(player_handle, old_cords);
+			if(!trigger.is_null()){
+				const auto resulting_event = collision_table.resolve(*registry->get(trigger), *player, delta_time);
+				if(is_game_event_event(resulting_event)){
+					return std::make_pair(resulting_event, trigger);
+				}
+			}
+		}
+		return std::make_pair(entity::GameEventTypes::None, entity::Handle());
+	}
+
+	auto Simulation::set_enemy_update_mode(EnemyUpdateMode mode, int threads) -> void {
+		enemy_update_mode = mode;
+		jobs.reset();
+		if(mode == EnemyUpdateMode::Parallel){
+			jobs.reset(new utils::JobSystem(threads));
+			query_contexts.resize(jobs->get_worker_count());
+		}
+	}
+
+	auto Simulation::set_use_components(bool use) -> void {
+		use_components = use;
+		enemy_components.clear();
+		if(use){
+			for(const auto handle : enemies){
+				enemy_components.add(handle, *registry->get(handle));
+			}
+		}
+	}
+
+	auto Simulation::update_enemies(float delta_time) -> entity::GameEventTypes {
+		plan_enemy_moves(delta_time);
+		const int count = static_cast<int>(enemy_snapshot.size());
+		const bool parallel = enemy_update_mode == EnemyUpdateMode::Parallel;
+		if(parallel){
+			sweep_enemies_parallel();
+		}
+		//commit pass, in the order of the snapshot
+		for(int i = 0; i < count; i++){
+			const auto handle = enemy_snapshot[i];
+			const auto enemy = registry->get_as<entity::Enemy>(handle);
+			if(use_components){
+				//the store did the steering, the enemy only catches up now that it is touched anyway
+				const int row = enemy_components.index_of(handle);
+				enemy->face(enemy_components.get_heading(row));
+				enemy->set_speed(enemy_components.get_speed()[row]);
+			}
+			const auto old_cords = enemy->get_cords();
+			const auto sweep = parallel ? enemy_sweeps[i] : collision_map->sweep(handle, enemy_moves[i]);
+			const auto result = apply_enemy_move(handle, enemy, old_cords, enemy_moves[i], sweep, enemy_plans[i], delta_time);
+			if(result == entity::GameEventTypes::GameOver){
+				return entity::GameEventTypes::GameOver;
+			}
+		}
+		return entity::GameEventTypes::None;
+	}
+
+	//speed, direction and the step each enemy wants to take this tick, in the order they will be applied
+	auto Simulation::plan_enemy_moves(float delta_time) -> void {
+		const bool speed_up = static_cast<int>(time) % speed_increasse_rate == 0;
+		//the order of the list, the same seed and input make the same adds and removes, so it is the same on every run
+		enemy_snapshot.assign(enemies.begin(), enemies.end());
+		const int count = static_cast<int>(enemy_snapshot.size());
+		enemy_moves.resize(count);
+		enemy_plans.resize(count);
+
+		//only does the work when the player got to another tile
+		flow_field.update(player->get_cords());
+		//increasse speed based on time
+		if(speed_up && use_components){
+			enemy_components.add_speed(speed_increasse);
+		}else if(speed_up){
+			for(const auto handle : enemy_snapshot){
+				const auto enemy = registry->get_as<entity::Enemy>(handle);
+				enemy->set_speed(enemy->get_speed() + speed_increasse);
+			}
+		}
+		enemy_lod.begin_tick();
+		const auto player_cords = player->get_cords();
+		int planned = 0;
+		for(int i = 0; i < count; i++){
+			const auto handle = enemy_snapshot[i];
+			const auto enemy = registry->get_as<entity::Enemy>(handle);
+			const auto d = enemy->get_cords() - player_cords;
+			const auto plan = enemy_lod.plan(handle, sqrtf(d.x*d.x + d.z*d.z));
+			if(!plan.full){
+				drift_enemy(handle, enemy);
+				continue;
+			}
+			//the way it goes is turned by think_enemies, only the length matters here
+			glm::vec4 move;
+			if(use_components){
+				const int row = enemy_components.index_of(handle);
+				move = enemy_components.get_heading(row) * (enemy_components.get_speed()[row] * delta_time);
+			}else{
+				move = step_displacement(enemy, delta_time);
+			}
+			//packs the ones with a full update at the front, in the same order
+			enemy_snapshot[planned] = handle;
+			enemy_moves[planned] = move * static_cast<float>(plan.ticks);
+			enemy_plans[planned] = plan;
+			planned++;
+		}
+		enemy_snapshot.resize(planned);
+		enemy_moves.resize(planned);
+		enemy_plans.resize(planned);
+		think_enemies();
+	}
+
+	auto Simulation::think_enemies() -> void {
+		const int count = static_cast<int>(enemy_snapshot.size());
+		for(int i = 0; i < count; i++){
+			ai_scheduler.request(enemy_snapshot[i]);
+		}
+		//the way to the player (or the car for a guard) bent by the crowd and the houses, all read before any is turned,
+		//a guard only changes its own path so the threads don't share anything
+		auto think = [&](const entity::Handle *handles, int think_count, glm::vec4 *decisions){
+			auto steer = [&](int begin, int end, int){
+				for(int i = begin; i < end; i++){
+					const auto enemy = registry->get(handles[i]);
+					const auto cords = enemy->get_cords();
+					glm::vec4 dir;
+					if(!guard_direction(handles[i], cords, dir)){
+						dir = flow_field.direction(cords.x, cords.z);
+					}
+					if(dir.x == 0.0f && dir.z == 0.0f){
+						decisions[i] = glm::vec4(0.0f);
+						continue;
+					}
+					decisions[i] = crowd.steer(*collision_map, *enemy, dir);
+				}
+			};
+			if(jobs){
+				jobs->parallel_for(think_count, 16, steer);
+			}else{
+				steer(0, think_count, 0);
+			}
+		};
+		ai_scheduler.run(think);
+
+		//the ones not served this tick go on by their last decision, the flow field until their first one
+		for(int i = 0; i < count; i++){
+			const auto handle = enemy_snapshot[i];
+			glm::vec4 heading;
+			if(!ai_scheduler.decision(handle, heading)){
+				const auto cords = registry->get(handle)->get_cords();
+				if(!guard_direction(handle, cords, heading)){
+					heading = flow_field.direction(cords.x, cords.z);
+				}
+			}
+			//no way to go, it was decided to stand still
+			if(heading.x == 0.0f && heading.z == 0.0f){
+				enemy_moves[i] = glm::vec4(0.0f);
+				continue;
+			}
+			const auto &move = enemy_moves[i];
+			enemy_moves[i] = heading * sqrtf(move.x*move.x + move.z*move.z);
+			if(use_components){
+				enemy_components.set_heading(enemy_components.index_of(handle), heading);
+			}else{
+				registry->get_as<entity::Enemy>(handle)->face(heading);
+			}
+		}
+	}
+
+	auto Simulation::assign_guard(entity::Handle handle) -> void {
+		if(!has_car){
+			return;
+		}
+		if(handle.index >= guards.size()){
+			guards.resize(handle.index + 1);
+		}
+		auto &guard = guards[handle.index];
+		guard.next = 0;
+		guard.active = find_path(registry->get(handle)->get_cords(), car_cords, guard.waypoints);
+	}
+	auto Simulation::guard_direction(entity::Handle handle, const glm::vec4 &cords, glm::vec4 &dir) -> bool {
+		if(handle.index >= guards.size() || !guards[handle.index].active){
+			return false;
+		}
+		auto &guard = guards[handle.index];
+		const auto to_player = player->get_cords() - cords;
+		if(to_player.x*to_player.x + to_player.z*to_player.z < guard_range * guard_range){
+			//for good, it doesn't go back to the car once it saw the player
+			guard.active = false;
+			return false;
+		}
+		//close enough to a waypoint is reaching it, the crowd pushes them around the exact point
+		const float reach = generator->get_tile_size() / 2;
+		const int count = static_cast<int>(guard.waypoints.size());
+		glm::vec4 d;
+		while(guard.next < count){
+			d = guard.waypoints[guard.next] - cords;
+			if(d.x*d.x + d.z*d.z > reach * reach){
+				break;
+			}
+			guard.next++;
+		}
+		if(guard.next == count){
+			//at the car, it stands there
+			dir = glm::vec4(0.0f);
+			return true;
+		}
+		const float length = sqrtf(d.x*d.x + d.z*d.z);
+		dir = glm::vec4(d.x / length, 0.0f, d.z / length, 0.0f);
+		return true;
+	}
+
+	//keeps going along the last swept move, without looking for collisions
+	auto Simulation::drift_enemy(entity::Handle handle, entity::Enemy *enemy) -> void {
+		const auto step = enemy_lod.drift(handle);
+		if(step.x == 0.0f && step.z == 0.0f){
+			return;
+		}
+		const auto old_cords = enemy->get_cords();
+		enemy->translate(step);
+		collision_map->relocate(handle, old_cords, enemy->get_cords());
+	}
+
+	/*
+	The sweeps of every enemy made at once over the positions at the start of the tick,
+	the moves are applied after, one enemy at a time.
+	An enemy does not see where the others are going this tick, only where they were.
+	*/
+	auto Simulation::sweep_enemies_parallel() -> void {
+		const int count = static_cast<int>(enemy_snapshot.size());
+		enemy_sweeps.resize(count);
+		//nothing is inserted, removed or moved until every sweep is done
+		for(auto &context : query_contexts){
+			context.stats = QueryStats();
+		}
+		jobs->parallel_for(count, 32, [&](int begin, int end, int worker){
+			auto &context = query_contexts[worker];
+			for(int i = begin; i < end; i++){
+				enemy_sweeps[i] = collision_map->sweep(enemy_snapshot[i], enemy_moves[i], context);
+			}
+		});
+		QueryStats tick_stats;
+		for(const auto &context : query_contexts){
+			tick_stats.cells_visited += context.stats.cells_visited;
+			tick_stats.candidates_tested += context.stats.candidates_tested;
+			tick_stats.hits += context.stats.hits;
+		}
+		collision_map->merge_stats(tick_stats, count);
+	}
+
+	auto Simulation::apply_enemy_move(entity::Handle handle, entity::Enemy *enemy, const glm::vec4 &old_cords,
+		const glm::vec4 &displacement, const SweepResult &sweep, const LodPlan &plan, float delta_time) -> entity::GameEventTypes {
+		auto move = displacement * sweep.time + sweep.remainder;
+		if(!sweep.hit.is_null()){
+			const auto resulting_state = collision_table.resolve(*registry->get(sweep.hit), *enemy, delta_time);
+			if(resulting_state == entity::GameEventTypes::GameOver){
+				collision_map->relocate(handle, old_cords, enemy->get_cords());
+				return entity::GameEventTypes::GameOver;
+			}
+			//a knock back already moved it, the slide was worked out from where it was before
+			if(enemy->get_cords() != old_cords){
+				move = glm::vec4(0.0f);
+			}
+		}
+		//a Mid enemy swept the moves of the next ticks, it takes one now and drifts the others
+		const auto step = move * plan.share;
+		enemy->translate(step);
+		if(plan.ticks > 1 && plan.share < 1.0f){
+			enemy_lod.set_drift(handle, step, plan.ticks - 1);
+		}
+		collision_map->relocate(handle, old_cords, enemy->get_cords());
+		return entity::GameEventTypes::None;
+	}
+}
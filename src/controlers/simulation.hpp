@@ -0,0 +1,184 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
+
+#include "../entities/entity.hpp"
+#include "../entities/registry.hpp"
+#include "../entities/components.hpp"
+#include "../entities/collision_table.hpp"
+#include "collision.hpp"
+#include "generator.hpp"
+#include "spawner.hpp"
+#include "enemy_lod.hpp"
+#include "flow_field.hpp"
+#include "road_planner.hpp"
+#include "crowd.hpp"
+#include "ai_scheduler.hpp"
+#include "input.hpp"
+#include "../utils/job_system.hpp"
+
+//the speeds and rates of the game are per 1/60 of a second, the frame time it was made with
+#define GAME_TIME_UNITS_PER_SECOND 60.0f
+
+namespace controler{
+	enum class EnemyUpdateMode{
+		Serial,
+		//sweeps of all enemies on the job system, then the moves applied in one pass
+		Parallel
+	};
+	/*
+	The game itself: the map, the entities, spawning, the enemies, the collisions and the game events.
+	It doesn't know about the window or OpenGL, so it runs the same with or without them.
+		Simulation sim(std::move(registry), std::move(collision_map), std::move(generator), player);
+		sim.start_round();
+		while(sim.tick(1.0f, input.next()) == entity::GameEventTypes::None){ ... }
+		sim.clear_round();
+	*/
+	class Simulation{
+	public:
+		Simulation(std::unique_ptr<entity::Registry> _registry,
+			std::unique_ptr<CollisionMap> _collision_map,
+			std::unique_ptr<Generator> _generator,
+			std::shared_ptr<entity::Player> _player);
+		~Simulation();
+
+		//generates the map and puts the player in a vacant tile
+		auto start_round() -> void;
+		//takes out everything of the round but the player
+		auto clear_round() -> void;
+		//one fixed step, returns EndPoint or GameOver when the round ended in it, None otherwise
+		auto tick(float delta_time, const TickInput &input) -> entity::GameEventTypes;
+
+		//the registry takes the ownership, the simulation keeps the handle
+		auto insert_enemy(std::shared_ptr<entity::Enemy> enemy) -> entity::Handle;
+		auto insert_wall(std::shared_ptr<entity::Wall> wall) -> entity::Handle;
+		auto insert_game_event(std::shared_ptr<entity::GameEvent> game_event) -> entity::Handle;
+		auto insert_background(std::shared_ptr<entity::Entity> bg) -> entity::Handle;
+		
+		//also destroys the entity (the enemies go back to the pool)
+		auto remove_enemy(entity::Handle enemy) -> void;
+		auto remove_wall(entity::Handle wall) -> void;
+		auto remove_game_event(entity::Handle game_event) -> void;
+		auto remove_background(entity::Handle bg) -> void;
+
+		//every random draw of the game comes from this seed, same seed and same input give the same game
+		auto set_seed(uint64_t seed) -> void;
+		inline auto get_seed() const -> uint64_t { return seed; }
+		inline auto set_spawn_settings(SpawnSettings settings) -> void { spawn_director.set_settings(settings); }
+		//threads are the extra threads of the pool, the moves are applied in the order of the list either way
+		auto set_enemy_update_mode(EnemyUpdateMode mode, int threads) -> void;
+		//keeps the heading and speed of the enemies in a ComponentStore, the passes that change them run over its arrays
+		auto set_use_components(bool use) -> void;
+		//separation, alignment and house avoidance of the enemies that get a full update
+		inline auto set_crowd_settings(CrowdSettings settings) -> void { crowd.set_settings(settings); }
+		//one in every spawns walks the roads to the car and waits there until the player gets within range, 0 for none
+		inline auto set_guard_settings(int every, float range) -> void { guard_every = every; guard_range = range; }
+		//how much of a tick the zombies can spend thinking, AiSettings::replayable() for recordings
+		inline auto set_ai_settings(AiSettings settings) -> void { ai_scheduler.set_settings(settings); }
+		//how often the enemies far from the player get a full update
+		inline auto set_lod_settings(LodSettings settings) -> void { enemy_lod.set_settings(settings); }
+
+		//waypoints from one point of the map to another, for whatever walks to something other than the player,
+		//the road graph of the round is built on the first call
+		auto find_path(const glm::vec4 &from, const glm::vec4 &to, std::vector<glm::vec4> &waypoints) -> bool;
+
+		//for the render
+		inline auto get_registry() const -> const entity::Registry& { return *registry; }
+		inline auto get_player() const -> entity::Player* { return player; }
+		inline auto get_enemies() const -> const std::vector<entity::Handle>& { return enemies; }
+		inline auto get_walls() const -> const std::vector<entity::Handle>& { return walls; }
+		inline auto get_game_events() const -> const std::vector<entity::Handle>& { return game_events; }
+		inline auto get_background() const -> const std::vector<entity::Handle>& { return background; }
+		inline auto get_collision_map() const -> const CollisionMap& { return *collision_map; }
+		inline auto get_enemy_lod() const -> const EnemyLod& { return enemy_lod; }
+		inline auto get_ai_stats() const -> const AiStats& { return ai_scheduler.get_stats(); }
+		inline auto get_flow_field() const -> const FlowField& { return flow_field; }
+		inline auto get_road_planner() const -> const RoadPlanner& { return road_planner; }
+		inline auto get_time() const -> float { return time; }
+		inline auto get_score() const -> int { return score; }
+	private:
+		auto update_player(float delta_time, const TickInput &input) -> std::pair<entity::GameEventTypes, entity::Handle>;
+		auto update_enemies(float delta_time) -> entity::GameEventTypes;
+		//a pooled zombie in a vacant tile
+		auto spawn_enemy() -> void;
+		//moves the zombie farthest from the player to a vacant tile, if it is far enough
+		auto recycle_far_enemy() -> void;
+		//puts an enemy of the registry in the game
+		auto activate_enemy(entity::Handle enemy) -> void;
+		//the enemies without a full update this tick only drift, the others are left in enemy_snapshot
+		auto plan_enemy_moves(float delta_time) -> void;
+		auto drift_enemy(entity::Handle handle, entity::Enemy *enemy) -> void;
+		//gives the enemy a path to the car if it is one of the guards
+		auto assign_guard(entity::Handle handle) -> void;
+		//the way along the path of a guard in dir, false if the enemy goes for the player
+		auto guard_direction(entity::Handle handle, const glm::vec4 &cords, glm::vec4 &dir) -> bool;
+		//the zombies served by the scheduler pick a new heading, the planned moves are turned to the headings
+		auto think_enemies() -> void;
+		auto sweep_enemies_parallel() -> void;
+		//moves the enemy by its share of the result of its sweep and fixes its cell
+		auto apply_enemy_move(entity::Handle handle, entity::Enemy *enemy, const glm::vec4 &old_cords,
+			const glm::vec4 &displacement, const SweepResult &sweep, const LodPlan &plan, float delta_time) -> entity::GameEventTypes;
+
+		//takes the points, returns the events that end the round
+		auto handle_event(entity::GameEventTypes game_event_type, entity::Handle game_event) -> entity::GameEventTypes;
+		auto is_game_event_event(entity::GameEventTypes game_event_type) -> bool;
+
+		//owns the entities, declared before the collision map since the map looks them up in it
+		std::unique_ptr<entity::Registry> registry;
+		std::unique_ptr<CollisionMap> collision_map;
+		std::unique_ptr<Generator> generator;
+		EnemyPool enemy_pool;
+		int zombie_archetype;
+
+		//entities
+		entity::Player *player;
+		entity::Handle player_handle;
+		std::vector<entity::Handle> enemies;
+		std::vector<entity::Handle> walls;
+		std::vector<entity::Handle> game_events;
+		std::vector<entity::Handle> background;
+		//the way to the player around the houses, for all the zombies
+		FlowField flow_field;
+		//paths to any other point, over the roads, empty until find_path is called in the round
+		RoadPlanner road_planner;
+		//the zombies that go to the car first, by the slot of the handle
+		struct GuardPath{
+			bool active = false;
+			int next = 0; //waypoint it walks to
+			std::vector<glm::vec4> waypoints;
+		};
+		std::vector<GuardPath> guards;
+		int guard_every = 6;
+		float guard_range = 60.0f;
+		long spawn_count = 0;
+		bool has_car = false;
+		glm::vec4 car_cords;
+		//what happens when two kinds of entities collide
+		entity::CollisionTable collision_table = entity::CollisionTable::standard();
+
+		uint64_t seed = 0;
+		int score = 0;
+		float time = 0;
+		SpawnDirector spawn_director{SpawnSettings{200.0f, 300, 150.0f}};
+
+		int speed_increasse_rate = 200;
+		float speed_increasse = 0.0025f;
+
+		//parallel enemy update
+		EnemyUpdateMode enemy_update_mode = EnemyUpdateMode::Serial;
+		std::unique_ptr<utils::JobSystem> jobs;
+		std::vector<QueryContext> query_contexts; //one per worker
+		std::vector<entity::Handle> enemy_snapshot;
+		std::vector<glm::vec4> enemy_moves;
+		std::vector<LodPlan> enemy_plans;
+		CrowdSteering crowd{CrowdSettings{4.0f, 1.5f, 0.3f, 6.0f, 1.0f}};
+		std::vector<SweepResult> enemy_sweeps;
+		EnemyLod enemy_lod{LodSettings{60.0f, 150.0f, 3, 12, 100}};
+		AiScheduler ai_scheduler{AiSettings{1000, 0, 64}};
+
+		bool use_components = false;
+		entity::ComponentStore enemy_components;
+	};
+}
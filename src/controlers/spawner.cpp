@@ -0,0 +1,104 @@
+#include "spawner.hpp"
+
+namespace controler{
+	auto EnemyArchetype::make(const glm::vec4 &pos) const -> std::shared_ptr<entity::Enemy> {
+		std::shared_ptr<entity::Enemy> enemy(new entity::Enemy(pos, gpu_program, mesh));
+
+		enemy->set_wire_mesh(wire_mesh);
+		enemy->set_wire_renderer(wire_renderer);
+
+		enemy->set_scale(scale.x, scale.y, scale.z);
+		enemy->set_base_translate(base_translate.x, base_translate.y, base_translate.z);
+		enemy->set_base_direction(base_direction);
+		enemy->set_bbox_type(bbox_type);
+		enemy->set_bbox_size(bbox_size.x, bbox_size.y, bbox_size.z);
+		reset(*enemy, pos);
+		return enemy;
+	}
+
+	auto EnemyArchetype::reset(entity::Enemy &enemy, const glm::vec4 &pos) const -> void {
+		enemy.set_cords(pos.x, pos.y, pos.z);
+		enemy.set_angles(0.0f, 0.0f, 0.0f);
+		enemy.set_speed(speed);
+		enemy.set_damage(damage);
+	}
+
+	/*****************************
+		EnemyPool implementation
+	******************************/
+	EnemyPool::EnemyPool(entity::Registry &registry): registry(registry){}
+
+	auto EnemyPool::add_archetype(const EnemyArchetype &archetype) -> int {
+		archetypes.push_back(archetype);
+		free_enemies.emplace_back();
+		return static_cast<int>(archetypes.size()) - 1;
+	}
+
+	auto EnemyPool::prewarm(int archetype, int count) -> void {
+		auto &list = free_enemies.at(archetype);
+		list.reserve(list.size() + count);
+		for(int i = 0; i < count; i++){
+			auto enemy = archetypes[archetype].make(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+			enemy->set_archetype(archetype);
+			list.push_back(registry.create(enemy));
+		}
+	}
+
+	auto EnemyPool::acquire(int archetype, const glm::vec4 &pos) -> entity::Handle {
+		auto &list = free_enemies.at(archetype);
+		while(!list.empty()){
+			const auto handle = list.back();
+			list.pop_back();
+			//someone may have destroyed it while it waited
+			if(auto enemy = registry.get_as<entity::Enemy>(handle)){
+				archetypes[archetype].reset(*enemy, pos);
+				return handle;
+			}
+		}
+		auto enemy = archetypes[archetype].make(pos);
+		enemy->set_archetype(archetype);
+		return registry.create(enemy);
+	}
+
+	auto EnemyPool::release(entity::Handle handle) -> void {
+		const auto enemy = registry.get_as<entity::Enemy>(handle);
+		if(enemy == nullptr){
+			return;
+		}
+		const int archetype = enemy->get_archetype();
+		if(archetype < 0 || archetype >= get_archetype_count()){
+			//not made by the pool
+			registry.destroy(handle);
+			return;
+		}
+		free_enemies[archetype].push_back(handle);
+	}
+
+	auto EnemyPool::clear() -> void {
+		for(auto &list : free_enemies){
+			for(const auto handle : list){
+				registry.destroy(handle);
+			}
+			list.clear();
+		}
+	}
+
+	/*****************************
+		SpawnDirector implementation
+	******************************/
+	SpawnDirector::SpawnDirector(SpawnSettings settings): settings(settings), since_last(settings.interval){}
+
+	auto SpawnDirector::update(float delta_time, int active) -> SpawnAction {
+		since_last += delta_time;
+		if(since_last < settings.interval){
+			return SpawnAction::None;
+		}
+		//no catching up, a long frame gives one spawn and not a burst
+		since_last = 0.0f;
+		return active < settings.max_active ? SpawnAction::Spawn : SpawnAction::Recycle;
+	}
+
+	auto SpawnDirector::reset() -> void {
+		since_last = settings.interval;
+	}
+}
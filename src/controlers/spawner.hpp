@@ -0,0 +1,91 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+#include "../entities/entity.hpp"
+#include "../entities/registry.hpp"
+#include "../renders/mesh.hpp"
+#include "../renders/shader.hpp"
+
+namespace controler{
+	//everything an enemy of a kind is set up with, so the setters run once per enemy and not once per spawn
+	struct EnemyArchetype{
+		std::shared_ptr<render::GPUprogram> gpu_program;
+		std::shared_ptr<render::Mesh> mesh;
+		std::shared_ptr<render::WireMesh> wire_mesh;
+		std::shared_ptr<render::GPUprogram> wire_renderer;
+
+		glm::vec4 scale;
+		glm::vec4 base_translate;
+		glm::vec4 base_direction;
+		entity::BBoxType bbox_type;
+		glm::vec4 bbox_size; //x radius, height, z radius
+		float speed;
+		int damage;
+
+		//a new enemy at pos already set up
+		auto make(const glm::vec4 &pos) const -> std::shared_ptr<entity::Enemy>;
+		//puts back what changes while an enemy is alive
+		auto reset(entity::Enemy &enemy, const glm::vec4 &pos) const -> void;
+	};
+	/*
+	Enemies that left the game are kept in the registry and reused by the next spawn of the same archetype,
+	so after the pool warmed up spawning doesn't allocate.
+		EnemyPool pool(registry);
+		const int zombie = pool.add_archetype(generator->get_enemy_archetype(MeshIds::ENEMY));
+		auto h = pool.acquire(zombie, pos);
+		pool.release(h); //h stays valid, it comes back on a next acquire
+	*/
+	class EnemyPool{
+		public:
+			EnemyPool(entity::Registry &registry);
+
+			auto add_archetype(const EnemyArchetype &archetype) -> int;
+			inline auto get_archetype_count() const -> int { return static_cast<int>(archetypes.size()); }
+			//creates enemies up front so the first spawns don't allocate
+			auto prewarm(int archetype, int count) -> void;
+
+			auto acquire(int archetype, const glm::vec4 &pos) -> entity::Handle;
+			auto release(entity::Handle enemy) -> void;
+			//destroys the enemies that are waiting in the pool
+			auto clear() -> void;
+
+			inline auto get_free_count(int archetype) const -> int { return static_cast<int>(free_enemies[archetype].size()); }
+		private:
+			entity::Registry &registry;
+			std::vector<EnemyArchetype> archetypes;
+			std::vector<std::vector<entity::Handle>> free_enemies; //by archetype
+	};
+
+	struct SpawnSettings{
+		float interval;          //min time between spawns, in the game time units
+		int max_active;          //over it the far zombies are recycled instead of spawning new ones
+		float recycle_distance;  //how far from the player a zombie has to be to be recycled
+	};
+	enum class SpawnAction{
+		None,
+		Spawn,
+		Recycle
+	};
+	/*
+	Decides when an enemy comes in: at most one every interval, whatever the frame rate,
+	and once there are max_active of them the far ones are moved instead.
+	*/
+	class SpawnDirector{
+		public:
+			SpawnDirector(SpawnSettings settings);
+
+			auto update(float delta_time, int active) -> SpawnAction;
+			//the next update spawns right away
+			auto reset() -> void;
+
+			inline auto get_settings() const -> const SpawnSettings& { return settings; }
+			inline auto set_settings(SpawnSettings s) -> void { settings = s; }
+		private:
+			SpawnSettings settings;
+			float since_last;
+	};
+}
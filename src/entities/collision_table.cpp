@@ -0,0 +1,56 @@
+#include "collision_table.hpp"
+
+namespace entity{
+	//calculate the normal of the colision and go a little back
+	static auto cause_knock_back(Entity &me, Entity &other, float delta_time) -> void {
+		const auto collision_normal = other.get_cords() - me.get_cords();
+		other.translate_direction(collision_normal/mtx::norm(collision_normal), delta_time);
+	}
+	static auto hurt(Player &player, const Enemy &enemy) -> GameEventTypes {
+		player.take_damage(enemy.get_damage());
+		if(player.get_life_points() < 0){
+			return GameEventTypes::GameOver;
+		}
+		return GameEventTypes::None;
+	}
+
+	/*
+	 * the responses, the kinds of the pair are checked by the table so the casts are safe
+	*/
+	static auto no_response(Entity &hit, Entity &mover, float delta_time) -> GameEventTypes {
+		return GameEventTypes::None;
+	}
+	//the player walked into an enemy
+	static auto enemy_hits_player(Entity &hit, Entity &mover, float delta_time) -> GameEventTypes {
+		cause_knock_back(hit, mover, delta_time);
+		return hurt(static_cast<Player&>(mover), static_cast<const Enemy&>(hit));
+	}
+	//an enemy walked into the player
+	static auto player_hits_enemy(Entity &hit, Entity &mover, float delta_time) -> GameEventTypes {
+		cause_knock_back(hit, mover, delta_time);
+		return hurt(static_cast<Player&>(hit), static_cast<const Enemy&>(mover));
+	}
+	static auto trigger_event(Entity &hit, Entity &mover, float delta_time) -> GameEventTypes {
+		return static_cast<const GameEvent&>(hit).get_type();
+	}
+
+	CollisionTable::CollisionTable(){
+		for(int i = 0; i < KINDS; i++){
+			for(int j = 0; j < KINDS; j++){
+				responses[i][j] = no_response;
+			}
+		}
+	}
+	auto CollisionTable::standard() -> CollisionTable {
+		CollisionTable table;
+		table.set(EntityKind::Enemy, EntityKind::Player, enemy_hits_player);
+		table.set(EntityKind::Player, EntityKind::Enemy, player_hits_enemy);
+		//the sweep already slides them along the walls, a knock back on top of it would make them jitter
+		table.set(EntityKind::GameEvent, EntityKind::Player, trigger_event);
+		table.set(EntityKind::GameEvent, EntityKind::Enemy, trigger_event);
+		return table;
+	}
+	auto CollisionTable::set(EntityKind hit, EntityKind mover, CollisionResponse response) -> void {
+		responses[static_cast<int>(hit)][static_cast<int>(mover)] = response == nullptr ? no_response : response;
+	}
+}
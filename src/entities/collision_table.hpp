@@ -0,0 +1,34 @@
+#pragma once
+
+#include "entity.hpp"
+
+namespace entity{
+	//what happens to both when mover runs into hit, the returned event goes to the GameLoop
+	typedef GameEventTypes (*CollisionResponse)(Entity &hit, Entity &mover, float delta_time);
+	/*
+	Table of the collision responses indexed by the kinds of the pair, (kind of what was hit, kind of the mover).
+	The response is picked by two array lookups, no virtual call or cast,
+	and a new kind of zombie or pickup is one row and one column more.
+		CollisionTable table = CollisionTable::standard();
+		table.set(EntityKind::GameEvent, EntityKind::Player, pick_up);
+		const auto event = table.resolve(*hit, *player, delta_time);
+	*/
+	class CollisionTable{
+		public:
+			//every pair starts doing nothing
+			CollisionTable();
+			//the responses of the game
+			static auto standard() -> CollisionTable;
+
+			auto set(EntityKind hit, EntityKind mover, CollisionResponse response) -> void;
+			inline auto get(EntityKind hit, EntityKind mover) const -> CollisionResponse {
+				return responses[static_cast<int>(hit)][static_cast<int>(mover)];
+			}
+			inline auto resolve(Entity &hit, Entity &mover, float delta_time) const -> GameEventTypes {
+				return get(hit.get_kind(), mover.get_kind())(hit, mover, delta_time);
+			}
+		private:
+			static const int KINDS = static_cast<int>(EntityKind::Count);
+			CollisionResponse responses[KINDS][KINDS];
+	};
+}
@@ -0,0 +1,58 @@
+#include "components.hpp"
+
+namespace entity{
+	auto ComponentStore::add(Handle handle, const Entity &entity) -> int {
+		int row = index_of(handle);
+		if(row == -1){
+			if(handle.index >= sparse.size()){
+				sparse.resize(handle.index + 1, -1);
+			}
+			row = size();
+			sparse[handle.index] = row;
+			handles.push_back(handle);
+			heading_x.push_back(0.0f); heading_z.push_back(0.0f);
+			speed.push_back(0.0f);
+		}
+		pull(row, entity);
+		return row;
+	}
+
+	auto ComponentStore::remove(Handle handle) -> bool {
+		const int row = index_of(handle);
+		if(row == -1){
+			return false;
+		}
+		const int last = size() - 1;
+		if(row != last){
+			handles[row] = handles[last];
+			sparse[handles[row].index] = row;
+			heading_x[row] = heading_x[last]; heading_z[row] = heading_z[last];
+			speed[row] = speed[last];
+		}
+		sparse[handle.index] = -1;
+		handles.pop_back();
+		heading_x.pop_back(); heading_z.pop_back();
+		speed.pop_back();
+		return true;
+	}
+
+	auto ComponentStore::clear() -> void {
+		sparse.clear();
+		handles.clear();
+		heading_x.clear(); heading_z.clear();
+		speed.clear();
+	}
+
+	auto ComponentStore::pull(int row, const Entity &entity) -> void {
+		const auto dir = entity.get_direction();
+		heading_x[row] = dir.x;
+		heading_z[row] = dir.z;
+		speed[row] = entity.get_speed();
+	}
+
+	auto ComponentStore::add_speed(float amount) -> void {
+		for(auto &s : speed){
+			s += amount;
+		}
+	}
+}
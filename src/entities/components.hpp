@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+#include "handle.hpp"
+#include "entity.hpp"
+
+namespace entity{
+	/*
+	The heading and speed of the enemies as one array per field, so the passes of the enemy update that only
+	steer and speed them up stream through two packed arrays instead of jumping between the entities.
+	It is opt-in and only covers those passes: while it is used the rows are the ones that hold the heading
+	and speed, the entities get them when they are moved. The position stays in the entities,
+	the CollisionMap and the render read it from there.
+		ComponentStore store;
+		store.add(handle, *registry.get(handle));
+		store.add_speed(amount);
+		store.set_heading(row, heading);
+		enemy->face(store.get_heading(row));
+		enemy->set_speed(store.get_speed()[row]);
+	The rows are dense, removing swaps the last row into the hole, so row indices change on remove.
+	*/
+	class ComponentStore{
+		public:
+			//returns the row, an entity already in the store is only refreshed
+			auto add(Handle handle, const Entity &entity) -> int;
+			auto remove(Handle handle) -> bool;
+			auto clear() -> void;
+
+			//copies the entity into its row
+			auto pull(int row, const Entity &entity) -> void;
+
+			auto add_speed(float amount) -> void;
+
+			inline auto index_of(Handle handle) const -> int {
+				if(handle.index >= sparse.size()){
+					return -1;
+				}
+				const int row = sparse[handle.index];
+				return row != -1 && handles[row] == handle ? row : -1;
+			}
+			inline auto has(Handle handle) const -> bool { return index_of(handle) != -1; }
+			inline auto size() const -> int { return static_cast<int>(handles.size()); }
+			inline auto get_handle(int row) const -> Handle { return handles[row]; }
+
+			//columns, the same row is the same entity in all of them
+			inline auto get_heading_x() const -> const float* { return heading_x.data(); }
+			inline auto get_heading_z() const -> const float* { return heading_z.data(); }
+			inline auto get_speed() const -> const float* { return speed.data(); }
+
+			inline auto get_heading(int row) const -> glm::vec4 { return glm::vec4(heading_x[row], 0.0f, heading_z[row], 0.0f); }
+			inline auto set_heading(int row, const glm::vec4 &dir) -> void { heading_x[row] = dir.x; heading_z[row] = dir.z; }
+		private:
+			std::vector<int> sparse; //handle index -> row, -1 if not in the store
+			std::vector<Handle> handles;
+
+			std::vector<float> heading_x, heading_z;
+			std::vector<float> speed;
+	};
+}
@@ -5,6 +5,7 @@
 #include "../renders/shader.hpp"
 #include "../renders/mesh.hpp"
 #include "geometry.hpp"
+#include "handle.hpp"
 #include "../utils/matrix.hpp"
 
 #define PI 3.141592f
@@ -16,59 +17,82 @@ namespace entity{
 		Point,
 		None
 	};
-	class Enemy;
+	//bit flags, an entity only collides with what is on the layers of its mask
+	enum CollisionLayer : unsigned {
+		LAYER_NONE = 0,
+		LAYER_SOLID = 1 << 0,       //walls and other static geometry
+		LAYER_MOVER = 1 << 1,       //player and enemies
+		LAYER_TRIGGER = 1 << 2,     //game events, they don't block anything
+		LAYER_PLAYER_ONLY = 1 << 3  //blocks only the player
+	};
 	class Player;
-	class Wall;
-	class GameEvent;
-	/*
-	* Okay, meio entendimento de single dispatch tava meio errado
-	* Dado q o player colidiu co algo no collision map, su vou chamar a função collide dessa entidade desconhecida
-	* Ou seja, 
-	*	- a parede deve ter funções que empurram o player e o inimigo
-	*   - o inimigo deve ter funções que empurra o player (e outros inimigos se pá)
-	*   - o game event deve ter funções q retornam o seu tipo quando colide com o player
-	*   - o player deve ter funções que empurram o inimigo 
-	*/
+	//what an entity is, the collision table (collision_table.hpp) picks the response by the kinds of the pair
+	enum class EntityKind : unsigned char {
+		None,       //background, it never collides
+		Enemy,
+		Player,
+		Wall,
+		GameEvent,
+		Count
+	};
 	//base do polimorfismo
 	class Entity : public Geometry, public render::Renderable {
-		//used both for single dispatch and to unite the Geometry and Renderable into one class
+		//unites the Geometry and Renderable into one class, the kind tells which one it is
 		public:
 			Entity(glm::vec4 cords, 
 				std::shared_ptr<render::GPUprogram> gpu_program,
 				std::shared_ptr<render::Mesh> mesh): Geometry(cords), render::Renderable(gpu_program, mesh){} 
 			Entity(){} 
 			virtual ~Entity(){}
-			virtual auto collide(std::shared_ptr<Enemy> enemy, float delta_time) -> GameEventTypes {
-				return GameEventTypes::None;
-			}
-			virtual auto collide(std::shared_ptr<Player> player, float delta_time) -> GameEventTypes {
-				return GameEventTypes::None;
-			}
-			virtual auto collide(std::shared_ptr<Wall> wall, float delta_time)  -> GameEventTypes {
-				return GameEventTypes::None;
-			}
-			virtual auto collide(std::shared_ptr<GameEvent> game_event, float delta_time) -> GameEventTypes {
-				return GameEventTypes::None;
-			}
+			inline auto get_kind() const -> EntityKind { return kind; }
+			//index inside the broadphase cell, kept by the collision map so removing is O(1)
+			inline auto get_cell_slot() const -> int { return cell_slot; }
+			inline auto set_cell_slot(int slot) -> void { cell_slot = slot; }
+
+			inline auto get_collision_layer() const -> unsigned { return collision_layer; }
+			inline auto get_collision_mask() const -> unsigned { return collision_mask; }
+			inline auto set_collision_layer(unsigned layer) -> void { collision_layer = layer; }
+			inline auto set_collision_mask(unsigned mask) -> void { collision_mask = mask; }
+			inline auto collides_with(const Entity &other) const -> bool { return (collision_mask & other.collision_layer) != 0; }
+
+			//set by the Registry, null while the entity is not in one
+			inline auto get_handle() const -> Handle { return handle; }
+			inline auto set_handle(Handle h) -> void { handle = h; }
+		protected:
+			inline auto set_kind(EntityKind k) -> void { kind = k; }
+		private:
+			Handle handle;
+			EntityKind kind = EntityKind::None;
+			int cell_slot = -1;
+			unsigned collision_layer = LAYER_SOLID;
+			unsigned collision_mask = LAYER_SOLID | LAYER_MOVER;
 	};
 	class Enemy : public Entity {
 		public:
 			Enemy(glm::vec4 cords, 
 				std::shared_ptr<render::GPUprogram> gpu_program,
-				std::shared_ptr<render::Mesh> mesh): Entity(cords, gpu_program, mesh){} 
-			Enemy(){}
+				std::shared_ptr<render::Mesh> mesh): Entity(cords, gpu_program, mesh){ set_layers(); } 
+			Enemy(){ set_layers(); }
 			virtual ~Enemy(){}
 			//if player is close goes in it's direction
 			//else move acording to Path
-			auto direct_towards_player(std::shared_ptr<Player> player) -> void;
+			auto direct_towards_player(const Player &player) -> void;
+			//turns the enemy so its direction is dir (on the ground plane)
+			auto face(const glm::vec4 &dir) -> void;
 			auto set_damage(int amount) -> void;
-			auto get_damage() -> int;
-			//specific collisions for each entity
-			virtual auto collide(std::shared_ptr<Player> player, float delta_time) -> GameEventTypes override;
-			//virtual auto collide(std::shared_ptr<Wall> wall, float delta_time)  -> GameEventTypes override;
+			auto get_damage() const -> int;
+			//kind of enemy it was made as by the EnemyPool, -1 if it was not made by one
+			inline auto get_archetype() const -> int { return archetype; }
+			inline auto set_archetype(int a) -> void { archetype = a; }
 		private: 
+			inline auto set_layers() -> void {
+				set_kind(EntityKind::Enemy);
+				set_collision_layer(LAYER_MOVER);
+				set_collision_mask(LAYER_SOLID | LAYER_MOVER);
+			}
 			//Path path;
 			int damage = 1;
+			int archetype = -1;
 	};
 	typedef struct PressedKeys{
 		bool w, a, s, d;
@@ -78,33 +102,30 @@ namespace entity{
 			
 			Player(glm::vec4 cords, 
 				std::shared_ptr<render::GPUprogram> gpu_program,
-				std::shared_ptr<render::Mesh> mesh): Entity(cords, gpu_program, mesh){} 
-			Player(){}
+				std::shared_ptr<render::Mesh> mesh): Entity(cords, gpu_program, mesh){ set_layers(); } 
+			Player(){ set_layers(); }
 			virtual ~Player(){}
 			auto direct_player(PressedKeys &keys, glm::vec4 dir, glm::vec4 up_vec) -> bool;
 			auto take_damage(int amount) -> void;
 			auto set_life_points(int amount) -> void;
-			auto get_life_points() -> int;
-			
-			//specific collisions for each entity
-			virtual auto collide(std::shared_ptr<Enemy> enemy, float delta_time) -> GameEventTypes override;
-			//virtual auto collide(std::shared_ptr<Wall> wall, float delta_time) -> GameEventTypes override;
-			//virtual auto collide(std::shared_ptr<GameEvent> game_event, float delta_time) -> GameEventTypes override;
+			auto get_life_points() const -> int;
 		private: 
+			inline auto set_layers() -> void {
+				set_kind(EntityKind::Player);
+				set_collision_layer(LAYER_MOVER);
+				set_collision_mask(LAYER_SOLID | LAYER_MOVER | LAYER_TRIGGER | LAYER_PLAYER_ONLY);
+			}
 			auto player_angle_from_keys(PressedKeys &keys, glm::vec4 dir, glm::vec4 up_vec) -> float;
 			int life_points = 3;
 	};
-	//this is needed so that the single dispatch works
+	//this is needed so that the collision table knows it is a wall
 	class Wall : public Entity {
 		public:
 			Wall(glm::vec4 cords, 
 				std::shared_ptr<render::GPUprogram> gpu_program,
-				std::shared_ptr<render::Mesh> mesh): Entity(cords, gpu_program, mesh){} 
-			Wall(){}
+				std::shared_ptr<render::Mesh> mesh): Entity(cords, gpu_program, mesh){ set_kind(EntityKind::Wall); } 
+			Wall(){ set_kind(EntityKind::Wall); }
 			virtual ~Wall(){}
-
-			virtual auto collide(std::shared_ptr<Enemy> enemy, float delta_time) -> GameEventTypes override;
-			virtual auto collide(std::shared_ptr<Player> player, float delta_time) -> GameEventTypes override;
 	};
 
 	class GameEvent : public Entity {
@@ -113,16 +134,18 @@ namespace entity{
 				glm::vec4 cords, 
 				std::shared_ptr<render::GPUprogram> gpu_program,
 				std::shared_ptr<render::Mesh> mesh,
-				GameEventTypes type): Entity(cords, gpu_program, mesh), type(type){} 
-			GameEvent(){}
+				GameEventTypes type): Entity(cords, gpu_program, mesh), type(type){ set_layers(); } 
+			GameEvent(){ set_layers(); }
 			virtual ~GameEvent(){}
 
-			inline auto get_type() -> GameEventTypes { return type; }
+			inline auto get_type() const -> GameEventTypes { return type; }
 			//inline auto set_type(GameEventTypes new_type) -> void { type = new_type; }
-
-			virtual auto collide(std::shared_ptr<Player> player, float delta_time) -> GameEventTypes override;
-			virtual auto collide(std::shared_ptr<Enemy> enemy, float delta_time) -> GameEventTypes override;
 		private:
+			inline auto set_layers() -> void {
+				set_kind(EntityKind::GameEvent);
+				set_collision_layer(LAYER_TRIGGER);
+				set_collision_mask(LAYER_NONE);
+			}
 			GameEventTypes type;
 	};
 }
\ No newline at end of file
@@ -26,6 +26,7 @@ namespace entity{
 		set_translation();
 		set_scaling();
 		set_base_translate(0,0,0);
+		save_previous_state();
 	}
 
 	Geometry::Geometry(glm::vec4 cords):
@@ -38,6 +39,7 @@ namespace entity{
 		set_translation();
 		set_scaling();
 		set_base_translate(0,0,0);
+		save_previous_state();
 	} 
 	Geometry::Geometry():
 	cords(glm::vec4(0.01f,0.01f,0.01f,0.0f)), direction(glm::vec4(1.0f,0.0f,0.0f,0.0f)), speed(0.01f),
@@ -49,6 +51,7 @@ namespace entity{
 		set_translation();
 		set_scaling();
 		set_base_translate(0,0,0);
+		save_previous_state();
 	}
 	Geometry::~Geometry(){
 
@@ -62,12 +65,16 @@ namespace entity{
 		cords += dir * (speed * delta_time);
 		set_translation();
 	}
+	auto Geometry::translate(const glm::vec4 displacement) -> void{
+		cords += displacement;
+		set_translation();
+	}
 	auto Geometry::rotate_increment(float x, float y, float z) -> void{
 		x_angle += x;
 		y_angle += y;
 		z_angle += z;
 		set_rotation();
-		direction = rotation * base_direction;
+		update_direction();
 	}
 	auto Geometry::set_cords(float x, float y, float z) -> void {
 		cords.x = x;
@@ -80,12 +87,12 @@ namespace entity{
 		y_angle = y;
 		z_angle = z;
 		set_rotation();
-		direction = rotation * base_direction;
+		update_direction();
 	}
 	auto Geometry::set_y_angle(float y) -> void {
 		y_angle = y;
 		set_rotation();
-		direction = rotation * base_direction;
+		update_direction();
 	}
 	auto Geometry::set_scale(float x, float y, float z) -> void {
 		x_scale = x;
@@ -93,6 +100,85 @@ namespace entity{
 		z_scale = z;
 		set_scaling();
 	}
+	auto Geometry::get_rotation() const -> const glm::mat4& {
+		if(dirty & DIRTY_ROTATION){
+			rotation = mtx::rot_z(z_angle) * mtx::rot_y(y_angle) * mtx::rot_x(x_angle);
+			dirty &= ~DIRTY_ROTATION;
+		}
+		return rotation;
+	}
+	auto Geometry::get_translation() const -> const glm::mat4& {
+		if(dirty & DIRTY_TRANSLATION){
+			translation = mtx::translate(cords.x,cords.y,cords.z);
+			dirty &= ~DIRTY_TRANSLATION;
+		}
+		return translation;
+	}
+	auto Geometry::get_transform() const -> const glm::mat4& {
+		if(dirty & DIRTY_TRANSFORM){
+			if(dirty & DIRTY_SCALING){
+				scaling = mtx::scale(x_scale, y_scale, z_scale);
+				dirty &= ~DIRTY_SCALING;
+			}
+			transform = get_translation() * get_rotation() * scaling * base_translate;
+			dirty &= ~DIRTY_TRANSFORM;
+		}
+		return transform;
+	}
+	auto Geometry::get_bbox_transform() const -> const glm::mat4& {
+		if(dirty & DIRTY_BBOX){
+			bbox_transform = get_translation() * get_bbox_scale();
+			dirty &= ~DIRTY_BBOX;
+		}
+		return bbox_transform;
+	}
+	auto Geometry::save_previous_state() -> void {
+		previous_cords = cords;
+		previous_y_angle = y_angle;
+	}
+	auto Geometry::get_interpolated_cords(float alpha) const -> glm::vec4 {
+		return previous_cords + (cords - previous_cords) * alpha;
+	}
+	auto Geometry::get_interpolated_transform(float alpha) const -> glm::mat4 {
+		const auto &current = get_transform();
+		if(alpha >= 1.0f || (previous_cords == cords && previous_y_angle == y_angle)){
+			return current;
+		}
+		//the angles are in [0, 2pi), it turns by the short way
+		const float pi = 3.141592f;
+		float turn = y_angle - previous_y_angle;
+		if(turn > pi) turn -= 2*pi;
+		if(turn < -pi) turn += 2*pi;
+		const auto pos = get_interpolated_cords(alpha);
+
+		auto rotation = mtx::rot_y(previous_y_angle + turn * alpha);
+		if(x_angle != 0.0f || z_angle != 0.0f){
+			rotation = mtx::rot_z(z_angle) * rotation * mtx::rot_x(x_angle);
+		}
+		//get_transform left the scaling up to date
+		return mtx::translate(pos.x, pos.y, pos.z) * rotation * scaling * base_translate;
+	}
+	auto Geometry::get_interpolated_bbox_transform(float alpha) const -> glm::mat4 {
+		if(alpha >= 1.0f || previous_cords == cords){
+			return get_bbox_transform();
+		}
+		const auto pos = get_interpolated_cords(alpha);
+		return mtx::translate(pos.x, pos.y, pos.z) * get_bbox_scale();
+	}
+	auto Geometry::update_direction() -> void {
+		if(x_angle == 0.0f && z_angle == 0.0f){
+			//rot_y applied to the base direction
+			const float c = cosf(y_angle);
+			const float s = sinf(y_angle);
+			direction = glm::vec4(
+				c * base_direction.x + s * base_direction.z,
+				base_direction.y,
+				-s * base_direction.x + c * base_direction.z,
+				base_direction.w);
+			return;
+		}
+		direction = get_rotation() * base_direction;
+	}
 	auto set_direction(glm::vec4 new_dir) -> void {
 		//TODO: set the direction and get the angles
 	}
@@ -28,6 +28,8 @@ namespace entity{
 			//normalize the vectors
 			auto translate_foward(const float delta_time) -> void;
 			auto translate_direction(const glm::vec4 dir, const float delta_time) -> void;
+			//moves by the displacement as is, without the speed
+			auto translate(const glm::vec4 displacement) -> void;
 
 			auto rotate_increment(float x, float y, float z) -> void;
 			auto set_cords(float x, float y, float z) -> void;
@@ -41,6 +43,7 @@ namespace entity{
 			
 			inline auto set_base_translate(float x, float y, float z) -> void {
 				base_translate = mtx::translate(x,y,z);
+				dirty |= DIRTY_TRANSFORM;
 			}
 			inline auto get_cords() const -> glm::vec4 { return cords; }
 
@@ -61,20 +64,27 @@ namespace entity{
 			inline auto get_height() const -> float { return height; }
 			inline auto get_z_radius() const -> float { return z_radius; }
 
-			inline auto set_x_radius(float x) -> void { x_radius = x; }
-			inline auto set_height(float y) -> void { height = y; }
-			inline auto set_z_radius(float z) -> void { z_radius = z; }
+			inline auto set_x_radius(float x) -> void { x_radius = x; dirty |= DIRTY_BBOX; }
+			inline auto set_height(float y) -> void { height = y; dirty |= DIRTY_BBOX; }
+			inline auto set_z_radius(float z) -> void { z_radius = z; dirty |= DIRTY_BBOX; }
 
-			inline auto set_bbox_size(float x, float y, float z) -> void {x_radius = x; height = y; z_radius = z; }
-			inline auto get_transform() const -> glm::mat4 {
-				return translation * rotation * scaling * base_translate;
-			}
-			inline auto get_translation() const -> glm::mat4 {
-				return translation;
-			} 
+			inline auto set_bbox_size(float x, float y, float z) -> void {x_radius = x; height = y; z_radius = z; dirty |= DIRTY_BBOX; }
+			//the matrices are cached and only rebuilt when what they are made of changed,
+			//so an entity that doesn't move pays for them once
+			auto get_transform() const -> const glm::mat4&;
+			auto get_translation() const -> const glm::mat4&;
+			//translation * bbox scale, to draw the bbox
+			auto get_bbox_transform() const -> const glm::mat4&;
 			inline auto get_bbox_scale() const -> glm::mat4 {
 				return mtx::scale(x_radius,height,z_radius);
 			}
+
+			//the state of the last tick, the render interpolates from it to the current one
+			auto save_previous_state() -> void;
+			auto get_interpolated_cords(float alpha) const -> glm::vec4;
+			//the transforms at alpha between the previous state and the current one
+			auto get_interpolated_transform(float alpha) const -> glm::mat4;
+			auto get_interpolated_bbox_transform(float alpha) const -> glm::mat4;
 		private:
 			//world coordinates
 			glm::vec4 cords;
@@ -90,20 +100,39 @@ namespace entity{
 			BBoxType bbox_type;
 			//how much it translates in a step
 			float speed;
+			//of the last tick
+			glm::vec4 previous_cords;
+			float previous_y_angle;
 
-			glm::mat4 rotation;
-			glm::mat4 translation;
-			glm::mat4 scaling;
 			glm::mat4 base_translate; //correcting translation for when models origins are not at their center
 
+			//caches, rebuilt on the first get after the flag is set
+			enum : unsigned {
+				DIRTY_ROTATION = 1 << 0,
+				DIRTY_TRANSLATION = 1 << 1,
+				DIRTY_SCALING = 1 << 2,
+				DIRTY_TRANSFORM = 1 << 3,
+				DIRTY_BBOX = 1 << 4,
+				DIRTY_ALL = 0x1F
+			};
+			mutable unsigned dirty = DIRTY_ALL;
+			mutable glm::mat4 rotation;
+			mutable glm::mat4 translation;
+			mutable glm::mat4 scaling;
+			mutable glm::mat4 transform;
+			mutable glm::mat4 bbox_transform;
+
+			auto get_rotation() const -> const glm::mat4&;
+			//the direction is the base direction rotated, without building the matrix when only the y angle is set
+			auto update_direction() -> void;
 			inline auto set_rotation() -> void{
-				rotation = mtx::rot_z(z_angle) * mtx::rot_y(y_angle) * mtx::rot_x(x_angle);
+				dirty |= DIRTY_ROTATION | DIRTY_TRANSFORM;
 			}
 			inline auto set_translation() -> void{
-				translation = mtx::translate(cords.x,cords.y,cords.z);
+				dirty |= DIRTY_TRANSLATION | DIRTY_TRANSFORM | DIRTY_BBOX;
 			}
 			inline auto set_scaling() -> void{
-				scaling = mtx::scale(x_scale, y_scale, z_scale);
+				dirty |= DIRTY_SCALING | DIRTY_TRANSFORM;
 			}
 	};
 }
\ No newline at end of file
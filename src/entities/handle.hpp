@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace entity{
+	/*
+	Reference to an entity of the Registry, the slot it lives in and the generation of the slot.
+	When the entity is destroyed the slot generation goes up, so old handles stop resolving.
+	The default handle is null, generation 0 is never given to an entity.
+	*/
+	struct Handle{
+		uint32_t index = 0;
+		uint32_t generation = 0;
+
+		Handle(){}
+		Handle(uint32_t index, uint32_t generation): index(index), generation(generation){}
+
+		inline auto is_null() const -> bool { return generation == 0; }
+		inline auto operator==(const Handle &other) const -> bool { return index == other.index && generation == other.generation; }
+		inline auto operator!=(const Handle &other) const -> bool { return !(*this == other); }
+	};
+	struct HandleHash{
+		inline auto operator()(const Handle &handle) const -> std::size_t {
+			//a shift by 32 is undefined on a 32 bit size_t, the multiply spreads the index over all the bits instead
+			return static_cast<std::size_t>(handle.index * 0x9E3779B1u ^ handle.generation);
+		}
+	};
+}
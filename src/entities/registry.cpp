@@ -0,0 +1,42 @@
+#include "registry.hpp"
+
+namespace entity{
+	auto Registry::create(std::shared_ptr<Entity> entity) -> Handle {
+		uint32_t index;
+		if(free_slots.empty()){
+			index = static_cast<uint32_t>(slots.size());
+			slots.emplace_back();
+		}else{
+			index = free_slots.back();
+			free_slots.pop_back();
+		}
+		Slot &slot = slots[index];
+		const Handle handle{index, slot.generation};
+		entity->set_handle(handle);
+		slot.entity = std::move(entity);
+		alive_count++;
+		return handle;
+	}
+
+	auto Registry::destroy(Handle handle) -> bool {
+		if(!alive(handle)){
+			return false;
+		}
+		Slot &slot = slots[handle.index];
+		slot.entity->set_handle(Handle());
+		slot.entity.reset();
+		//skips 0 on wrap around, it is the null generation
+		slot.generation = slot.generation + 1 == 0 ? 1 : slot.generation + 1;
+		free_slots.push_back(handle.index);
+		alive_count--;
+		return true;
+	}
+
+	auto Registry::clear() -> void {
+		for(uint32_t i = 0; i < slots.size(); i++){
+			if(slots[i].entity != nullptr){
+				destroy(Handle{i, slots[i].generation});
+			}
+		}
+	}
+}
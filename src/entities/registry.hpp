@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "handle.hpp"
+#include "entity.hpp"
+
+namespace entity{
+	/*
+	Owns every entity of the game, the rest of the code keeps handles to them.
+		Registry registry;
+		const auto h = registry.create(std::shared_ptr<Entity>(new Enemy(...)));
+		if(auto enemy = registry.get_as<Enemy>(h)) ...
+		registry.destroy(h); //registry.get(h) is nullptr from now on
+	The slots are reused, the entity pointer of a slot stays the same while it is alive.
+	*/
+	class Registry{
+		public:
+			auto create(std::shared_ptr<Entity> entity) -> Handle;
+			//returns false if the handle was already stale
+			auto destroy(Handle handle) -> bool;
+			auto clear() -> void;
+
+			inline auto alive(Handle handle) const -> bool {
+				return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+			}
+			//nullptr if the handle is null or stale
+			inline auto get(Handle handle) const -> Entity* {
+				return alive(handle) ? slots[handle.index].entity.get() : nullptr;
+			}
+			//only for handles known to hold a T, like the ones of the typed lists of the GameLoop
+			template<class T>
+			inline auto get_as(Handle handle) const -> T* {
+				return static_cast<T*>(get(handle));
+			}
+			inline auto size() const -> int { return alive_count; }
+		private:
+			struct Slot{
+				std::shared_ptr<Entity> entity;
+				uint32_t generation = 1;
+			};
+			std::vector<Slot> slots;
+			std::vector<uint32_t> free_slots;
+			int alive_count = 0;
+	};
+}
@@ -1,11 +1,15 @@
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <cstdint>
 #include <ctime>
 // Headers abaixo são específicos de C++
 #include <vector>
 #include <iostream>
 #include <memory>
+#include <thread>
+#include <algorithm>
 // Headers das bibliotecas OpenGL
 #include <glad/glad.h>   // Criação de contexto OpenGL 3.3
 #include <GLFW/glfw3.h>  // Criação de janelas do sistema operacional
@@ -14,14 +18,17 @@
 #include "utils/matrix.hpp"
 #include "utils/animation.hpp"
 #include "entities/entity.hpp"
+#include "entities/registry.hpp"
 #include "entities/camera.hpp"
 #include "entities/screen.hpp"
 #include "renders/mesh.hpp"
 #include "controlers/collision.hpp"
+#include "controlers/simulation.hpp"
 #include "controlers/gameloop.hpp"
 
 #define PI 3.141592f
-#define TARGET_FRAME_RATE 60.0f
+#define SIM_TICK_RATE 60.0f
+#define SIM_MAX_CATCH_UP 5
 #define WINDOW_HEIGHT 800
 #define WINDOW_WIDTH  800
 #define log(text) std::cout << text << std::endl
@@ -49,7 +56,7 @@ typedef struct {
 } WindowSize;
 WindowSize g_windowSize {WINDOW_WIDTH,WINDOW_HEIGHT};
 entity::PressedKeys g_keys{false, false, false, false};
-void game_loop(GLFWwindow *window){
+void game_loop(GLFWwindow *window, const char *record_path, const char *replay_path){
 
 	//log("load shaders");
 	//carrega os shaders
@@ -127,12 +134,28 @@ void game_loop(GLFWwindow *window){
 	game_generator->insert_tile_mesh('C', cross_section_tile_mesh); //asphalt
 
 	//log("inicializando o controler");
+	//the whole map fits in the dense grid of 20 x 20 cells, world_size / 20 = 15 units each for the 10 tile map;
+	//a house reaches 0.75 * tile_size (11.25) from its center and a zombie 1, less than a cell,
+	//so anything a mover can touch is in the 3x3 cells around it
+	const float world_size = game_generator->get_map_size() * 2 * game_generator->get_tile_size();
+
+	std::unique_ptr<entity::Registry> registry(new entity::Registry());
+	std::unique_ptr<controler::CollisionMap> collision_map(
+		new controler::CollisionMap(*registry,world_size,world_size,20,20,controler::BroadPhaseType::Grid));
+
+	const auto player_cords = player->get_cords();
+	std::unique_ptr<controler::Simulation> simulation(
+		new controler::Simulation(std::move(registry), std::move(collision_map), std::move(game_generator), player));
+	//the enemies query the collision map from every core, leaving one for the main thread
+	const int extra_threads = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0);
+	simulation->set_enemy_update_mode(controler::EnemyUpdateMode::Parallel, extra_threads);
+	simulation->set_use_components(true);
+	//a new game every time, unless a recording is replayed
+	simulation->set_seed(static_cast<uint64_t>(time(0)));
 
 	controler::GameLoop game_controler(
-		std::unique_ptr<entity::Camera>(new entity::Camera(player->get_cords())),
-		std::unique_ptr<controler::CollisionMap>(new controler::CollisionMap(100,100,10,10)),
-		std::move(game_generator),
-		player,
+		std::unique_ptr<entity::Camera>(new entity::Camera(player_cords)),
+		std::move(simulation),
 		phong_phong, phong_diffuse, gouraud_phong, gouraud_diffuse,
 		wire_renderer, menu_renderer,
 		&g_keys, &g_look_at_parameters,
@@ -192,6 +215,18 @@ void game_loop(GLFWwindow *window){
 	game_controler.insert_screen(controler::GameState::GameWin, game_win_screen);
 	game_controler.insert_screen(controler::GameState::Credits, credits_screen);
 
+	game_controler.set_tick_rate(SIM_TICK_RATE, SIM_MAX_CATCH_UP);
+	try{
+		if(replay_path != nullptr){
+			game_controler.replay_input(replay_path);
+		}else if(record_path != nullptr){
+			game_controler.record_input(record_path);
+		}
+	}catch(const std::exception& e){
+		print_exception(e,0);
+		std::exit(EXIT_FAILURE);
+	}
+
 	float last_frame = (float)glfwGetTime();
 	//log("iniciando o loop de render");
     // Ficamos em um loop infinito, renderizando, até que o usuário feche a janela
@@ -199,18 +234,28 @@ void game_loop(GLFWwindow *window){
     {
 		glfwPollEvents();
 		float now = (float)glfwGetTime();
-		float delta_time = (now - last_frame) * TARGET_FRAME_RATE;
+		float frame_seconds = now - last_frame;
 		last_frame = now;
 	    glClearColor(0.04f, 0.04f, 0.1f, 1.0f); // define a cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // pinta os pixels do framebuffer 
 
-		game_controler.update(delta_time);
+		game_controler.update(frame_seconds);
 
         glfwSwapBuffers(window);
     }
 }
 int main(int argc, char** argv)
 {
+	//--record file saves the session, --replay file plays one back
+	const char *record_path = nullptr;
+	const char *replay_path = nullptr;
+	for(int i = 1; i + 1 < argc; i++){
+		if(std::strcmp(argv[i], "--record") == 0){
+			record_path = argv[++i];
+		}else if(std::strcmp(argv[i], "--replay") == 0){
+			replay_path = argv[++i];
+		}
+	}
     //Init da lib GLFW
     if (!glfwInit()){
        	std::cerr << "ERROR: glfwInit() failed.\n" << std::endl;
@@ -240,13 +285,12 @@ int main(int argc, char** argv)
        	std::cerr << "ERROR: gladLoadGLLoader() failed.\n" << std::endl;
         std::exit(EXIT_FAILURE);
 	}
-	srand(time(0));
     glEnable(GL_DEPTH_TEST);
 	glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
     glFrontFace(GL_CCW);
 
-	game_loop(window);
+	game_loop(window, record_path, replay_path);
 
     // Finalizamos o uso dos recursos do sistema operacional
 	glfwDestroyWindow(window);
@@ -0,0 +1,85 @@
+/*
+	Checks that the AiScheduler keeps the time of a tick close to its budget when the horde is far bigger
+	than what fits in it, and that every zombie still gets its turn.
+	usage: bin/test_ai_scheduler
+*/
+#include <cstdio>
+#include <chrono>
+#include <vector>
+
+#include "../controlers/ai_scheduler.hpp"
+
+#define CHECK(cond) if(!(cond)){ std::printf("FAILED %s:%d %s\n", __FILE__, __LINE__, #cond); failures++; }
+
+using Clock = std::chrono::steady_clock;
+
+static int failures = 0;
+
+//about as long as a flow field lookup and a crowd steer
+auto busy_think(const entity::Handle *handles, int count, glm::vec4 *decisions) -> void {
+	for(int i = 0; i < count; i++){
+		const auto start = Clock::now();
+		while(std::chrono::duration<double, std::micro>(Clock::now() - start).count() < 2.0){}
+		decisions[i] = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+	}
+}
+
+auto test_budget_holds() -> void {
+	const long budget = 500;
+	const int horde = 5000;
+	const int ticks = 60;
+	controler::AiScheduler ai(controler::AiSettings{budget, 0, 64});
+	std::vector<entity::Handle> zombies;
+	for(int i = 0; i < horde; i++){
+		zombies.push_back(entity::Handle(i, 1));
+	}
+	double total_us = 0.0;
+	int far_over = 0;
+	for(int t = 0; t < ticks; t++){
+		for(const auto zombie : zombies){
+			ai.request(zombie);
+		}
+		ai.run(busy_think);
+		const auto &stats = ai.get_stats();
+		total_us += stats.used_us;
+		//a thread switch in the middle of a think can always happen, only a few ticks may show it
+		if(stats.used_us > budget * 1.25){
+			far_over++;
+		}
+	}
+	const double mean_us = total_us / ticks;
+	std::printf("budget %ld us, mean %.1f us, ticks over 1.25x %d, think %.2f us\n",
+		budget, mean_us, far_over, ai.get_stats().think_us);
+	CHECK(mean_us <= budget * 1.1);
+	CHECK(mean_us >= budget * 0.8);
+	CHECK(far_over <= ticks / 10);
+	CHECK(ai.get_stats().pending > 0);
+}
+
+auto test_everyone_thinks() -> void {
+	controler::AiScheduler ai(controler::AiSettings{0, 10, 4});
+	std::vector<entity::Handle> zombies;
+	for(int i = 0; i < 35; i++){
+		zombies.push_back(entity::Handle(i, 1));
+		ai.request(zombies.back());
+	}
+	for(int t = 0; t < 4; t++){
+		ai.run(busy_think);
+		CHECK(ai.get_stats().thinks == (t < 3 ? 10 : 5));
+	}
+	glm::vec4 heading;
+	for(const auto zombie : zombies){
+		CHECK(ai.decision(zombie, heading));
+	}
+}
+
+int main(){
+	test_budget_holds();
+	test_everyone_thinks();
+	if(failures != 0){
+		std::printf("%d failed\n", failures);
+		return 1;
+	}
+	std::printf("ok\n");
+	return 0;
+}
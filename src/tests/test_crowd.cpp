@@ -0,0 +1,63 @@
+/*
+	Checks that the crowd steering pulls apart two zombies standing on the same spot,
+	the same way every time, one to each side.
+	usage: bin/test_crowd
+*/
+#include <cstdio>
+#include <cmath>
+#include <memory>
+
+#include "../controlers/crowd.hpp"
+#include "../controlers/collision.hpp"
+#include "../entities/entity.hpp"
+#include "../entities/registry.hpp"
+
+#define CHECK(cond) if(!(cond)){ std::printf("FAILED %s:%d %s\n", __FILE__, __LINE__, #cond); failures++; }
+
+static int failures = 0;
+
+auto make_zombie(entity::Registry &registry, controler::CollisionMap &map, const glm::vec4 &pos) -> entity::Handle {
+	std::shared_ptr<entity::Enemy> enemy(new entity::Enemy(pos, nullptr, nullptr));
+	enemy->set_bbox_type(entity::BBoxType::Cylinder);
+	enemy->set_bbox_size(1.0f, 2.0f, 1.0f);
+	enemy->set_speed(0.05f);
+	const auto handle = registry.create(enemy);
+	map.insert_mover(handle);
+	return handle;
+}
+
+auto test_coincident_zombies_split() -> void {
+	entity::Registry registry;
+	controler::CollisionMap map(registry, 300.0f, 300.0f, 20, 20, controler::BroadPhaseType::Grid);
+	const auto spot = glm::vec4(150.0f, 0.0f, 150.0f, 1.0f);
+	const auto a = make_zombie(registry, map, spot);
+	const auto b = make_zombie(registry, map, spot);
+
+	controler::CrowdSteering crowd(controler::CrowdSettings{4.0f, 1.5f, 0.0f, 6.0f, 0.0f});
+	const auto desired = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+	const auto heading_a = crowd.steer(map, *registry.get(a), desired);
+	const auto heading_b = crowd.steer(map, *registry.get(b), desired);
+
+	//a step along each heading puts them apart
+	const float dx = heading_a.x - heading_b.x;
+	const float dz = heading_a.z - heading_b.z;
+	std::printf("a (%.3f, %.3f) b (%.3f, %.3f)\n", heading_a.x, heading_a.z, heading_b.x, heading_b.z);
+	CHECK(sqrtf(dx*dx + dz*dz) > 0.1f);
+	//both still unit headings on the ground
+	CHECK(fabsf(sqrtf(heading_a.x*heading_a.x + heading_a.z*heading_a.z) - 1.0f) < 1e-4f);
+	CHECK(fabsf(sqrtf(heading_b.x*heading_b.x + heading_b.z*heading_b.z) - 1.0f) < 1e-4f);
+
+	//the same pair always splits the same way
+	const auto again = crowd.steer(map, *registry.get(a), desired);
+	CHECK(again.x == heading_a.x && again.z == heading_a.z);
+}
+
+int main(){
+	test_coincident_zombies_split();
+	if(failures != 0){
+		std::printf("%d failed\n", failures);
+		return 1;
+	}
+	std::printf("ok\n");
+	return 0;
+}
@@ -0,0 +1,220 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+
+namespace utils {
+	ScratchArena::ScratchArena(std::size_t block_size): block_size(block_size) {}
+
+	auto ScratchArena::alloc(std::size_t bytes, std::size_t align) -> void* {
+		while(current < blocks.size()){
+			auto &block = blocks[current];
+			const auto base = reinterpret_cast<std::uintptr_t>(block.data.get());
+			const std::size_t start = ((base + offset + align - 1) & ~(align - 1)) - base;
+			if(start + bytes <= block.size){
+				offset = start + bytes;
+				return block.data.get() + start;
+			}
+			current++;
+			offset = 0;
+		}
+		const std::size_t size = std::max(block_size, bytes + align);
+		blocks.push_back(Block{std::unique_ptr<char[]>(new char[size]), size});
+		capacity += size;
+		current = blocks.size() - 1;
+		offset = 0;
+		return alloc(bytes, align);
+	}
+
+	auto ScratchArena::reset() -> void {
+		if(blocks.size() > 1){
+			blocks.clear();
+			blocks.push_back(Block{std::unique_ptr<char[]>(new char[capacity]), capacity});
+		}
+		current = 0;
+		offset = 0;
+	}
+
+	//which system and worker the running thread belongs to
+	static thread_local const JobSystem *tls_system = nullptr;
+	static thread_local int tls_worker = 0;
+
+	JobSystem::JobSystem(int n_threads): queued(0), steals(0), sleeping(0) {
+		const int workers = std::max(n_threads, 0) + 1;
+		for(int i = 0; i < workers; i++){
+			queues.emplace_back(new Queue());
+			scratch.emplace_back(new ScratchArena());
+		}
+		for(int i = 1; i < workers; i++){
+			threads.emplace_back(&JobSystem::worker_main, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem(){
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for(auto &thread : threads){
+			thread.join();
+		}
+	}
+
+	auto JobSystem::current_worker() const -> int {
+		return tls_system == this ? tls_worker : 0;
+	}
+
+	auto JobSystem::run(TaskGroup &group, Job job) -> void {
+		const int worker = current_worker();
+		group.pending.fetch_add(1);
+		{
+			auto &queue = *queues[worker];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.entries.push_back(Entry{std::move(job), &group});
+		}
+		queued.fetch_add(1);
+		//the lock makes sure a worker that is about to sleep sees the job or gets the notify
+		if(sleeping.load() > 0){
+			{
+				std::lock_guard<std::mutex> lock(sleep_mutex);
+			}
+			wake.notify_one();
+		}
+	}
+
+	auto JobSystem::run_one(int worker) -> bool {
+		Entry entry;
+		bool found = false;
+		{
+			auto &own = *queues[worker];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if(!own.entries.empty()){
+				entry = std::move(own.entries.back());
+				own.entries.pop_back();
+				found = true;
+			}
+		}
+		const int workers = get_worker_count();
+		for(int i = 1; i < workers && !found; i++){
+			auto &victim = *queues[(worker + i) % workers];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if(!victim.entries.empty()){
+				entry = std::move(victim.entries.front());
+				victim.entries.pop_front();
+				found = true;
+				steals.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		if(!found){
+			return false;
+		}
+		queued.fetch_sub(1);
+		entry.job(worker);
+		entry.group->pending.fetch_sub(1);
+		return true;
+	}
+
+	auto JobSystem::wait(TaskGroup &group) -> void {
+		const int worker = current_worker();
+		while(!group.done()){
+			if(!run_one(worker)){
+				//the rest of the group is running on other threads
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	auto JobSystem::parallel_for(int count, int chunk, const RangeTask &task) -> void {
+		if(count <= 0){
+			return;
+		}
+		chunk = std::max(chunk, 1);
+		const int worker = current_worker();
+		if(threads.empty() || count <= chunk){
+			task(0, count, worker);
+			return;
+		}
+		TaskGroup group;
+		split_range(0, count, chunk, task, group, worker);
+		wait(group);
+	}
+
+	//gives away the upper half and keeps splitting the lower, so a thief takes a big piece at once
+	auto JobSystem::split_range(int begin, int end, int chunk, const RangeTask &task, TaskGroup &group, int worker) -> void {
+		while(end - begin > chunk){
+			const int middle = begin + (end - begin) / 2;
+			run(group, [this, middle, end, chunk, &task, &group](int thief){
+				split_range(middle, end, chunk, task, group, thief);
+			});
+			end = middle;
+		}
+		task(begin, end, worker);
+	}
+
+	auto JobSystem::reset_scratch() -> void {
+		for(auto &arena : scratch){
+			arena->reset();
+		}
+	}
+
+	auto JobSystem::worker_main(int worker) -> void {
+		tls_system = this;
+		tls_worker = worker;
+		while(true){
+			if(run_one(worker)){
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(sleep_mutex);
+			sleeping.fetch_add(1);
+			wake.wait(lock, [this]{ return stopping || queued.load() > 0; });
+			sleeping.fetch_sub(1);
+			if(stopping){
+				return;
+			}
+		}
+	}
+
+	auto TaskGraph::add(JobSystem::Job job) -> int {
+		Node node;
+		node.job = std::move(job);
+		nodes.push_back(std::move(node));
+		return static_cast<int>(nodes.size()) - 1;
+	}
+
+	auto TaskGraph::precede(int before, int after) -> void {
+		nodes[before].next.push_back(after);
+		nodes[after].dependencies++;
+	}
+
+	auto TaskGraph::run(JobSystem &jobs) -> void {
+		const int count = size();
+		waiting.reset(new std::atomic<int>[count]);
+		for(int i = 0; i < count; i++){
+			waiting[i].store(nodes[i].dependencies);
+		}
+		TaskGroup group;
+		for(int i = 0; i < count; i++){
+			if(nodes[i].dependencies == 0){
+				schedule(jobs, group, i);
+			}
+		}
+		jobs.wait(group);
+	}
+
+	//the dependents are queued before the node counts as done, so the group never hits 0 early
+	auto TaskGraph::schedule(JobSystem &jobs, TaskGroup &group, int node) -> void {
+		jobs.run(group, [this, &jobs, &group, node](int worker){
+			nodes[node].job(worker);
+			for(const int next : nodes[node].next){
+				if(waiting[next].fetch_sub(1) == 1){
+					schedule(jobs, group, next);
+				}
+			}
+		});
+	}
+
+	auto TaskGraph::clear() -> void {
+		nodes.clear();
+		waiting.reset();
+	}
+}
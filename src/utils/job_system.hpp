@@ -0,0 +1,157 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <cstddef>
+#include <cstdint>
+
+namespace utils {
+	/*
+	Bump allocator for the temporary data of a job, everything goes away at once on reset.
+	Only for types that don't need their destructor called.
+		auto *hits = arena.alloc_array<int>(count);
+		...
+		arena.reset(); //between frames, when no job is using it
+	*/
+	class ScratchArena {
+		public:
+			ScratchArena(std::size_t block_size = 64 * 1024);
+			ScratchArena(const ScratchArena&) = delete;
+			auto operator=(const ScratchArena&) -> ScratchArena& = delete;
+
+			auto alloc(std::size_t bytes, std::size_t align = alignof(std::max_align_t)) -> void*;
+			template<class T>
+			inline auto alloc_array(std::size_t count) -> T* {
+				return static_cast<T*>(alloc(sizeof(T) * count, alignof(T)));
+			}
+			//keeps the memory, if it took more than one block they become one so the next frame fits
+			auto reset() -> void;
+			inline auto get_capacity() const -> std::size_t { return capacity; }
+		private:
+			struct Block{
+				std::unique_ptr<char[]> data;
+				std::size_t size;
+			};
+			std::vector<Block> blocks;
+			std::size_t block_size;
+			std::size_t capacity = 0;
+			std::size_t current = 0; //block being filled
+			std::size_t offset = 0;  //inside the current block
+	};
+
+	//counts the jobs of a batch that are not done yet, JobSystem::wait returns when it gets to 0
+	class TaskGroup {
+		public:
+			TaskGroup(): pending(0){}
+			TaskGroup(const TaskGroup&) = delete;
+			auto operator=(const TaskGroup&) -> TaskGroup& = delete;
+			inline auto done() const -> bool { return pending.load() == 0; }
+		private:
+			friend class JobSystem;
+			std::atomic<int> pending;
+	};
+
+	/*
+	Threads that stay alive and run jobs. Each one has its own queue: it takes its newest job first
+	and, when it is out of work, steals the oldest job of another queue, so big jobs split among idle threads.
+	The thread that made the system is worker 0 and runs jobs too while it waits.
+		JobSystem jobs(3);
+		jobs.parallel_for(n, 64, [&](int begin, int end, int worker){ ... });
+
+		TaskGroup group;
+		jobs.run(group, [&](int worker){ ... });
+		jobs.run(group, [&](int worker){ ... });
+		jobs.wait(group);
+	worker goes from 0 to get_worker_count() - 1, so it can index per thread data like get_scratch(worker).
+	*/
+	class JobSystem {
+		public:
+			using Job = std::function<void(int worker)>;
+			using RangeTask = std::function<void(int begin, int end, int worker)>;
+
+			//threads besides the caller, 0 runs everything on the caller
+			JobSystem(int threads);
+			~JobSystem();
+			JobSystem(const JobSystem&) = delete;
+			auto operator=(const JobSystem&) -> JobSystem& = delete;
+
+			//the group must outlive the job, wait on it before it goes out of scope
+			auto run(TaskGroup &group, Job job) -> void;
+			//runs jobs (of any group) until the ones of the group are done
+			auto wait(TaskGroup &group) -> void;
+			//splits the range in halves until they are at most chunk long, returns when all of it ran
+			auto parallel_for(int count, int chunk, const RangeTask &task) -> void;
+
+			inline auto get_worker_count() const -> int { return static_cast<int>(queues.size()); }
+			//index of the calling thread, 0 for threads that are not of this system
+			auto current_worker() const -> int;
+
+			inline auto get_scratch(int worker) -> ScratchArena& { return *scratch[worker]; }
+			//resets the arenas of every worker, only while no job runs
+			auto reset_scratch() -> void;
+
+			//jobs taken from the queue of another worker, for the benchmarks
+			inline auto get_steals() const -> long { return steals.load(); }
+		private:
+			struct Entry{
+				Job job;
+				TaskGroup *group;
+			};
+			struct Queue{
+				std::mutex mutex;
+				std::deque<Entry> entries;
+			};
+
+			auto worker_main(int worker) -> void;
+			//runs one job from its own queue or stolen from another, false if there was none
+			auto run_one(int worker) -> bool;
+			auto split_range(int begin, int end, int chunk, const RangeTask &task, TaskGroup &group, int worker) -> void;
+
+			std::vector<std::unique_ptr<Queue>> queues; //one per worker, 0 is the caller's
+			std::vector<std::unique_ptr<ScratchArena>> scratch;
+			std::vector<std::thread> threads;
+
+			std::atomic<int> queued;
+			std::atomic<long> steals;
+			std::atomic<int> sleeping;
+			std::mutex sleep_mutex;
+			std::condition_variable wake;
+			bool stopping = false;
+	};
+
+	/*
+	Jobs with dependencies, each node runs once every node it depends on is done.
+		TaskGraph graph;
+		const int ai = graph.add([&](int worker){ ... });
+		const int physics = graph.add([&](int worker){ ... });
+		graph.precede(ai, physics);
+		graph.run(jobs);
+	The graph can run again, the nodes and edges stay until clear.
+	*/
+	class TaskGraph {
+		public:
+			auto add(JobSystem::Job job) -> int;
+			//after only starts once before is done
+			auto precede(int before, int after) -> void;
+			//returns when every node ran, the graph must have no cycles
+			auto run(JobSystem &jobs) -> void;
+			auto clear() -> void;
+			inline auto size() const -> int { return static_cast<int>(nodes.size()); }
+		private:
+			struct Node{
+				JobSystem::Job job;
+				std::vector<int> next;
+				int dependencies = 0;
+			};
+			auto schedule(JobSystem &jobs, TaskGroup &group, int node) -> void;
+
+			std::vector<Node> nodes;
+			std::unique_ptr<std::atomic<int>[]> waiting; //dependencies not done yet, by node, while running
+	};
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <functional>
+#include <cstddef>
+
+namespace utils {
+	/*
+	Map of a fixed size that drops the entry used the longest time ago when it is full.
+		LruCache<uint64_t, Route> cache(256);
+		if(const auto *route = cache.get(key)){ ... }
+		else{ cache.put(key, plan(...)); }
+	The pointer get returns is valid until the next put.
+	*/
+	template<class Key, class Value, class Hash = std::hash<Key>>
+	class LruCache {
+		public:
+			LruCache(std::size_t capacity): capacity(capacity > 0 ? capacity : 1) {}
+
+			//nullptr if it is not in the cache, the entry becomes the most recent
+			inline auto get(const Key &key) -> const Value* {
+				const auto it = index.find(key);
+				if(it == index.end()){
+					misses++;
+					return nullptr;
+				}
+				hits++;
+				entries.splice(entries.begin(), entries, it->second);
+				return &it->second->second;
+			}
+			//returns the value in the cache
+			inline auto put(const Key &key, Value value) -> const Value* {
+				const auto it = index.find(key);
+				if(it != index.end()){
+					it->second->second = std::move(value);
+					entries.splice(entries.begin(), entries, it->second);
+					return &it->second->second;
+				}
+				if(entries.size() == capacity){
+					index.erase(entries.back().first);
+					entries.pop_back();
+				}
+				entries.emplace_front(key, std::move(value));
+				index[key] = entries.begin();
+				return &entries.front().second;
+			}
+			inline auto clear() -> void {
+				entries.clear();
+				index.clear();
+			}
+
+			inline auto size() const -> std::size_t { return entries.size(); }
+			inline auto get_capacity() const -> std::size_t { return capacity; }
+			inline auto get_hits() const -> long { return hits; }
+			inline auto get_misses() const -> long { return misses; }
+		private:
+			typedef std::pair<Key, Value> Entry;
+			std::size_t capacity;
+			std::list<Entry> entries; //the most recent first
+			std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index;
+			long hits = 0;
+			long misses = 0;
+	};
+}
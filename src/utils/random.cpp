@@ -0,0 +1,39 @@
+#include "random.hpp"
+
+namespace utils {
+	//splitmix64, spreads close seeds (0, 1, 2...) far apart
+	static auto mix(uint64_t x) -> uint64_t {
+		x += 0x9E3779B97F4A7C15ull;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+
+	Random::Random(uint64_t seed){
+		this->seed(seed);
+	}
+	auto Random::seed(uint64_t seed) -> void {
+		state = mix(seed);
+		//xorshift never leaves 0
+		if(state == 0){
+			state = 0x9E3779B97F4A7C15ull;
+		}
+	}
+	auto Random::next() -> uint32_t {
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return static_cast<uint32_t>((state * 0x2545F4914F6CDD1Dull) >> 32);
+	}
+	auto Random::below(uint32_t n) -> uint32_t {
+		//multiply and shift instead of %, no bias towards the low numbers worth caring about
+		return static_cast<uint32_t>((static_cast<uint64_t>(next()) * n) >> 32);
+	}
+	auto Random::unit() -> float {
+		//the 24 bits a float holds, more would round up to 1
+		return (next() >> 8) * (1.0f / 16777216.0f);
+	}
+	auto Random::derive(uint64_t session_seed, RandomStream stream) -> uint64_t {
+		return mix(session_seed ^ mix(static_cast<uint64_t>(stream)));
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+namespace utils {
+	//each part of the game that draws random numbers has its own sequence, so one drawing more doesn't change the others
+	enum class RandomStream : uint64_t {
+		Map = 1,        //the wave function collapse of the char map
+		Pickups = 2,    //the points placed on the roads
+		Placement = 3   //vacant tiles for the player and the zombies
+	};
+	/*
+	Small seeded generator (xorshift64*), the same seed gives the same numbers on every machine.
+		Random map_random(Random::derive(session_seed, RandomStream::Map));
+		const int tile = map_random.below(size);
+	*/
+	class Random {
+		public:
+			Random(uint64_t seed = 1);
+
+			auto seed(uint64_t seed) -> void;
+			auto next() -> uint32_t;
+			//from 0 to n - 1, 0 if n is 0
+			auto below(uint32_t n) -> uint32_t;
+			//from 0 to just under 1
+			auto unit() -> float;
+
+			//the seed of a stream from the seed of the session
+			static auto derive(uint64_t session_seed, RandomStream stream) -> uint64_t;
+		private:
+			uint64_t state;
+	};
+}
@@ -0,0 +1,30 @@
+#include "sim_clock.hpp"
+
+#include <cmath>
+
+namespace utils {
+	SimClock::SimClock(float tick_rate, int max_steps){
+		set_tick_rate(tick_rate);
+		set_max_steps(max_steps);
+	}
+	auto SimClock::advance(float seconds) -> int {
+		accumulator += seconds > 0.0f ? seconds : 0.0f;
+		int steps = 0;
+		while(accumulator >= step && steps < max_steps){
+			accumulator -= step;
+			steps++;
+		}
+		if(accumulator >= step){
+			dropped_steps += static_cast<long>(accumulator / step);
+			accumulator = fmodf(accumulator, step);
+		}
+		return steps;
+	}
+	auto SimClock::reset() -> void {
+		accumulator = 0.0f;
+	}
+	auto SimClock::set_tick_rate(float tick_rate) -> void {
+		step = 1.0f / (tick_rate > 0.0f ? tick_rate : 1.0f);
+		accumulator = 0.0f;
+	}
+}
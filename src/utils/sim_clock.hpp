@@ -0,0 +1,38 @@
+#pragma once
+
+namespace utils {
+	/*
+	Fixed step clock for the simulation, the frames add the real time and it says how many ticks to run.
+	What is left over is the alpha the render uses to interpolate between the last two ticks.
+		SimClock clock(60.0f, 5);
+		const int ticks = clock.advance(frame_seconds);
+		for(int i = 0; i < ticks; i++) tick(clock.get_step());
+		render(clock.get_alpha());
+	After max_steps in one frame the rest is dropped, so a hitch slows the game down instead of
+	making the next frames run more and more ticks.
+	*/
+	class SimClock {
+		public:
+			SimClock(float tick_rate, int max_steps);
+
+			//adds the real time that passed and returns how many ticks to run now
+			auto advance(float seconds) -> int;
+			//forgets the time not simulated yet, for when the simulation was paused
+			auto reset() -> void;
+
+			auto set_tick_rate(float tick_rate) -> void;
+			inline auto set_max_steps(int steps) -> void { max_steps = steps < 1 ? 1 : steps; }
+
+			//seconds of a tick
+			inline auto get_step() const -> float { return step; }
+			//how far the render is between the previous tick and the last one, from 0 to 1
+			inline auto get_alpha() const -> float { return accumulator / step; }
+			//ticks that were skipped because of the catch up cap
+			inline auto get_dropped_steps() const -> long { return dropped_steps; }
+		private:
+			float step;
+			int max_steps;
+			float accumulator = 0.0f;
+			long dropped_steps = 0;
+	};
+}